@@ -0,0 +1,133 @@
+// HostArduino.cpp — simulated Arduino runtime for the host build.
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace hostsim {
+
+// Microseconds since the simulated boot. Atomic because the optional service
+// task (std::thread on the host) reads the clock too.
+static std::atomic<uint64_t> s_nowUs { 0 };
+static std::atomic<uint32_t> s_spinStepUs { 1 };
+
+static std::atomic<bool>     s_realTime { false };
+static std::chrono::steady_clock::time_point s_realStart;
+static thread_local int64_t s_threadOffsetUs = 0;
+static thread_local int32_t s_threadSkewPpm  = 0;
+
+static uint64_t realUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_realStart).count();
+}
+
+void     setMillis(uint32_t ms)         { s_nowUs = (uint64_t)ms * 1000; }
+void     advanceMillis(uint32_t ms)     { s_nowUs += (uint64_t)ms * 1000; }
+void     advanceMicros(uint32_t us)     { s_nowUs += us; }
+uint64_t nowMicros()                    { return s_realTime ? realUs() : (uint64_t)s_nowUs; }
+void     setSpinStepMicros(uint32_t us) { s_spinStepUs = us; }
+
+void useRealTime(bool on) {
+  if (on && !s_realTime) s_realStart = std::chrono::steady_clock::now() - std::chrono::microseconds((uint64_t)s_nowUs);
+  s_realTime = on;
+}
+
+void setThreadClock(int64_t offsetUs, int32_t skewPpm) {
+  s_threadOffsetUs = offsetUs;
+  s_threadSkewPpm  = skewPpm;
+}
+
+static uint64_t readClockUs() {
+  const uint64_t t = s_realTime ? realUs() : s_nowUs.fetch_add(s_spinStepUs) + s_spinStepUs;
+  if (s_threadOffsetUs == 0 && s_threadSkewPpm == 0) return t;
+  return t + s_threadOffsetUs + (int64_t)t * s_threadSkewPpm / 1000000;
+}
+
+static void sleepOrAdvanceUs(uint32_t us) {
+  if (s_realTime) std::this_thread::sleep_for(std::chrono::microseconds(us));
+  else            s_nowUs += us;
+}
+
+// Function-local so Serial (a static FakeUart) can register during static init.
+static std::vector<FakeUart*>& registry() {
+  static std::vector<FakeUart*> list;
+  return list;
+}
+
+const std::vector<FakeUart*>& uarts() { return registry(); }
+FakeUart* lastUart() { return registry().empty() ? nullptr : registry().back(); }
+
+FakeUart::FakeUart() { registry().push_back(this); }
+
+FakeUart::~FakeUart() {
+  std::vector<FakeUart*>& list = registry();
+  list.erase(std::remove(list.begin(), list.end(), this), list.end());
+}
+
+size_t FakeUart::write(uint8_t c) {
+  if (_capture) _tx.push_back((char)c);
+  if (_echo) fputc(c, stdout);
+  return 1;
+}
+
+int FakeUart::read() {
+  if (_rx.empty()) return -1;
+  const uint8_t c = _rx.front();
+  _rx.pop_front();
+  return c;
+}
+
+static int s_pinLevel[64];
+static bool s_pinLevelInit = false;
+
+void setPinLevel(uint8_t pin, int level) {
+  if (!s_pinLevelInit) { for (int& l : s_pinLevel) l = HIGH; s_pinLevelInit = true; }
+  if (pin < 64) s_pinLevel[pin] = level;
+}
+
+static int pinLevel(uint8_t pin) {
+  if (!s_pinLevelInit) setPinLevel(0, HIGH);
+  return pin < 64 ? s_pinLevel[pin] : HIGH;
+}
+
+}  // namespace hostsim
+
+namespace {
+// Serial echoes instead of capturing, so long runs do not grow memory.
+struct SerialInit {
+  SerialInit() {
+    Serial.setEcho(true);
+    Serial.setCapture(false);
+  }
+};
+}  // namespace
+
+HardwareSerial Serial(0);
+static SerialInit s_serialInit;
+
+uint32_t millis() { return (uint32_t)(hostsim::readClockUs() / 1000); }
+uint32_t micros() { return (uint32_t)hostsim::readClockUs(); }
+void     delay(uint32_t ms)             { hostsim::sleepOrAdvanceUs(ms * 1000); }
+void     delayMicroseconds(uint32_t us) { hostsim::sleepOrAdvanceUs(us); }
+void     yield() {}
+
+static uint32_t s_randomState = 1;
+
+void randomSeed(unsigned long seed) { s_randomState = seed ? (uint32_t)seed : 1; }
+
+// xorshift32: deterministic across platforms, like a seeded random() on target.
+long random(long maxExclusive) {
+  if (maxExclusive <= 0) return 0;
+  s_randomState ^= s_randomState << 13;
+  s_randomState ^= s_randomState >> 17;
+  s_randomState ^= s_randomState << 5;
+  return (long)(s_randomState % (uint32_t)maxExclusive);
+}
+
+long random(long minInclusive, long maxExclusive) {
+  if (maxExclusive <= minInclusive) return minInclusive;
+  return minInclusive + random(maxExclusive - minInclusive);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+int  digitalRead(uint8_t pin) { return hostsim::pinLevel(pin); }
+void digitalWrite(uint8_t pin, uint8_t level) { hostsim::setPinLevel(pin, level); }
@@ -0,0 +1,92 @@
+// HostSim.h
+#pragma once
+#include <Arduino.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+// Control surface of the simulated Arduino runtime used by the host build
+// (see README.md). Library code keeps using millis()/delay()/Serial; the
+// harness drives time and inspects UART traffic through hostsim::.
+
+namespace hostsim {
+
+// ── Virtual clock ────────────────────────────────────────────────────────────
+// millis()/micros() read a virtual clock that only moves when told to:
+// advanceMillis()/advanceMicros(), delay()/delayMicroseconds(), and a small
+// step on every clock read (setSpinStepMicros) so busy-wait loops such as the
+// pacing spin in executePlayerCommandNowBase() terminate.
+void     setMillis(uint32_t ms);
+void     advanceMillis(uint32_t ms);
+void     advanceMicros(uint32_t us);
+uint64_t nowMicros();
+void     setSpinStepMicros(uint32_t us);  // default 1 µs per clock read; 0 = frozen
+
+// ── Real time and per-thread clocks ─────────────────────────────────────────
+// For multi-node simulations (several controllers on threads, talking over
+// loopback UDP). useRealTime(): the clock follows the host's steady clock and
+// delay() sleeps. setThreadClock(): millis()/micros() on the calling thread
+// read a node-local clock, true * (1 + skewPpm / 1e6) + offsetUs, like a board
+// with its own crystal and boot time. nowMicros() always returns true time.
+void     useRealTime(bool on);
+void     setThreadClock(int64_t offsetUs, int32_t skewPpm);
+
+// ── GPIO ─────────────────────────────────────────────────────────────────────
+// digitalRead() returns the level set here (default HIGH, as with a pull-up).
+void     setPinLevel(uint8_t pin, int level);
+
+// ── Fake UARTs ───────────────────────────────────────────────────────────────
+// Serial and every SoftwareSerial/HardwareSerial the backends create are
+// FakeUarts: bytes written are captured in tx(), bytes queued with injectRx()
+// are returned by read().
+class FakeUart : public Stream {
+public:
+  FakeUart();
+  ~FakeUart() override;
+  FakeUart(const FakeUart&) = delete;
+  FakeUart& operator=(const FakeUart&) = delete;
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override { return (int)_rx.size(); }
+  int read() override;
+  int peek() override { return _rx.empty() ? -1 : _rx.front(); }
+  operator bool() const { return true; }
+
+  void begin(unsigned long baud, int config = 0, int rxPin = -1, int txPin = -1, bool invert = false) {
+    (void)config; (void)rxPin; (void)txPin; (void)invert;
+    _baud = baud;
+  }
+  void end() {}
+  unsigned long baud() const { return _baud; }
+
+  // Harness side
+  const std::string& tx() const { return _tx; }
+  void clearTx() { _tx.clear(); }
+  void injectRx(const uint8_t* data, size_t len) { _rx.insert(_rx.end(), data, data + len); }
+  void setEcho(bool echo) { _echo = echo; }  // copy tx bytes to stdout
+  void setCapture(bool capture) { _capture = capture; }
+
+private:
+  std::string         _tx;
+  std::deque<uint8_t> _rx;
+  unsigned long       _baud = 0;
+  bool                _echo = false;
+  bool                _capture = true;
+};
+
+const std::vector<FakeUart*>& uarts();  // creation order; Serial is first
+FakeUart* lastUart();                   // most recently created (usually the backend's)
+
+}  // namespace hostsim
+
+class HardwareSerial : public hostsim::FakeUart {
+public:
+  explicit HardwareSerial(int uartNum = 0) : _uartNum(uartNum) {}
+  int uartNum() const { return _uartNum; }
+private:
+  int _uartNum;
+};
+
+// Echoes to stdout and does not capture by default; see HostArduino.cpp.
+extern HardwareSerial Serial;
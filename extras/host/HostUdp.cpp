@@ -0,0 +1,71 @@
+// HostUdp.cpp — POSIX UDP behind the Arduino UDP interface (host build).
+#include "HostUdp.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+uint8_t HostUdp::begin(uint16_t port) {
+  stop();
+  _fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (_fd < 0) return 0;
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  socklen_t len = sizeof(addr);
+  if (bind(_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || getsockname(_fd, (sockaddr*)&addr, &len) != 0) {
+    stop();
+    return 0;
+  }
+  fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL, 0) | O_NONBLOCK);
+  _localPort = ntohs(addr.sin_port);
+  return 1;
+}
+
+void HostUdp::stop() {
+  if (_fd >= 0) close(_fd);
+  _fd = -1;
+  _localPort = 0;
+}
+
+int HostUdp::beginPacket(IPAddress ip, uint16_t port) {
+  _txIp = ip;
+  _txPort = port;
+  _tx.clear();
+  return _fd >= 0;
+}
+
+int HostUdp::endPacket() {
+  if (_fd < 0) return 0;
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = (uint32_t)_txIp;  // already network byte order
+  addr.sin_port = htons(_txPort);
+  const ssize_t n = sendto(_fd, _tx.data(), _tx.size(), 0, (sockaddr*)&addr, sizeof(addr));
+  _tx.clear();
+  return n >= 0;
+}
+
+int HostUdp::parsePacket() {
+  _rx.clear();
+  _rxPos = 0;
+  if (_fd < 0) return 0;
+  uint8_t buf[1500];
+  sockaddr_in from = {};
+  socklen_t len = sizeof(from);
+  const ssize_t n = recvfrom(_fd, buf, sizeof(buf), 0, (sockaddr*)&from, &len);
+  if (n <= 0) return 0;
+  _rx.assign(buf, buf + n);
+  _remoteIp = IPAddress((uint32_t)from.sin_addr.s_addr);
+  _remotePort = ntohs(from.sin_port);
+  return (int)n;
+}
+
+int HostUdp::read(unsigned char* buffer, size_t len) {
+  const size_t n = std::min(len, _rx.size() - _rxPos);
+  memcpy(buffer, _rx.data() + _rxPos, n);
+  _rxPos += n;
+  return (int)n;
+}
@@ -0,0 +1,46 @@
+// HostUdp.h
+#pragma once
+#include <Udp.h>
+#include <vector>
+
+// UDP for the host build: a non-blocking POSIX datagram socket behind the
+// Arduino UDP interface, so networked library code (PlayerClockSync) runs
+// unchanged against loopback. IPv4 only.
+class HostUdp : public UDP {
+public:
+  HostUdp() {}
+  ~HostUdp() override { stop(); }
+  HostUdp(const HostUdp&) = delete;
+  HostUdp& operator=(const HostUdp&) = delete;
+
+  uint8_t begin(uint16_t port) override;  // port 0: the kernel picks one
+  void stop() override;
+  uint16_t localPort() const { return _localPort; }
+
+  int beginPacket(IPAddress ip, uint16_t port) override;
+  int endPacket() override;
+  size_t write(uint8_t c) override { _tx.push_back(c); return 1; }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    _tx.insert(_tx.end(), buffer, buffer + size);
+    return size;
+  }
+
+  int parsePacket() override;
+  int available() override { return (int)(_rx.size() - _rxPos); }
+  int read() override { return _rxPos < _rx.size() ? _rx[_rxPos++] : -1; }
+  int read(unsigned char* buffer, size_t len) override;
+  int peek() override { return _rxPos < _rx.size() ? _rx[_rxPos] : -1; }
+  IPAddress remoteIP() override { return _remoteIp; }
+  uint16_t remotePort() override { return _remotePort; }
+
+private:
+  int       _fd = -1;
+  uint16_t  _localPort = 0;
+  IPAddress _txIp;
+  uint16_t  _txPort = 0;
+  std::vector<uint8_t> _tx;
+  std::vector<uint8_t> _rx;
+  size_t    _rxPos = 0;
+  IPAddress _remoteIp;
+  uint16_t  _remotePort = 0;
+};
@@ -0,0 +1,132 @@
+// Arduino.h — simulated Arduino core for the host build (extras/host).
+// Only what the BauklankPlayerController core and the UART backends use.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HEX 16
+#define DEC 10
+#define SERIAL_8N1   0x800001c
+#define SWSERIAL_8N1 0
+
+// Flash strings are plain strings on the host.
+class __FlashStringHelper;
+#define F(s)     (s)
+#define PSTR(s)  (s)
+#define PROGMEM
+
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+void     delayMicroseconds(uint32_t us);
+void     yield();
+long     random(long maxExclusive);
+long     random(long minInclusive, long maxExclusive);
+void     randomSeed(unsigned long seed);
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+void     pinMode(uint8_t pin, uint8_t mode);
+int      digitalRead(uint8_t pin);
+void     digitalWrite(uint8_t pin, uint8_t level);
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+inline T constrain(T x, L lo, H hi) { return x < (T)lo ? (T)lo : (x > (T)hi ? (T)hi : x); }
+
+class String : public std::string {
+public:
+  String() {}
+  String(const char* s) : std::string(s ? s : "") {}
+  String(const std::string& s) : std::string(s) {}
+  String(int v) : std::string(std::to_string(v)) {}
+  String(unsigned long v) : std::string(std::to_string(v)) {}
+  void remove(size_t index) { if (index < size()) erase(index); }
+  void remove(size_t index, size_t count) { if (index < size()) erase(index, count); }
+  bool startsWith(const char* prefix) const { return compare(0, strlen(prefix), prefix) == 0; }
+  bool endsWith(const char* suffix) const {
+    const size_t n = strlen(suffix);
+    return size() >= n && compare(size() - n, n, suffix) == 0;
+  }
+  String substring(size_t from) const { return String(std::string::substr(from)); }
+  String substring(size_t from, size_t to) const { return String(std::string::substr(from, to - from)); }
+  int toInt() const { return atoi(c_str()); }
+};
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b); }
+inline String operator+(const String& a, const char* b) { return String(std::string(a) + b); }
+inline String operator+(const String& a, const String& b) { return String(std::string(a) + std::string(b)); }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    for (size_t i = 0; i < n; ++i) write(buf[i]);
+    return n;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+  size_t print(const char* s)          { return write(s); }
+  size_t print(const String& s)        { return write((const uint8_t*)s.c_str(), s.size()); }
+  size_t print(char c)                 { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC)           { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC)  { return print((unsigned long)v, base); }
+  size_t print(short v, int base = DEC)         { return print((long)v, base); }
+  size_t print(unsigned short v, int base = DEC){ return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC) {
+    char b[24];
+    if (base == HEX) snprintf(b, sizeof(b), "%lX", (unsigned long)v);
+    else             snprintf(b, sizeof(b), "%ld", v);
+    return write(b);
+  }
+  size_t print(unsigned long v, int base = DEC) {
+    char b[24];
+    snprintf(b, sizeof(b), base == HEX ? "%lX" : "%lu", v);
+    return write(b);
+  }
+  size_t print(double v, int digits = 2) {
+    char b[40];
+    snprintf(b, sizeof(b), "%.*f", digits, v);
+    return write(b);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(const T& v)          { size_t n = print(v);       return n + println(); }
+  template <class T> size_t println(const T& v, int fmt) { size_t n = print(v, fmt);  return n + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char b[512];
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(b, sizeof(b), fmt, args);
+    va_end(args);
+    return n <= 0 ? 0 : write((const uint8_t*)b, strnlen(b, sizeof(b)));
+  }
+
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+#include "HostSim.h"
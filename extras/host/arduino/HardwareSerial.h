@@ -0,0 +1,3 @@
+// HardwareSerial.h — simulated for the host build (defined in HostSim.h).
+#pragma once
+#include <Arduino.h>
@@ -0,0 +1,14 @@
+// SoftwareSerial.h — simulated for the host build: a FakeUart with the
+// EspSoftwareSerial constructor/begin() signatures the backends use.
+#pragma once
+#include <Arduino.h>
+
+class SoftwareSerial : public hostsim::FakeUart {
+public:
+  SoftwareSerial() {}
+  SoftwareSerial(int rxPin, int txPin, bool invert = false) { (void)rxPin; (void)txPin; (void)invert; }
+  bool isListening() const { return _listening; }
+  bool listen() { _listening = true; return true; }
+private:
+  bool _listening = true;
+};
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""Compare two player_bench CSV runs and flag regressions.
+
+    make bench && cp build/bench.csv baseline.csv     # before a change
+    make bench && python3 bench_compare.py baseline.csv build/bench.csv
+
+Virtual-time metrics are deterministic, so any change beyond --threshold is
+reported. CPU timings (unit "ns") vary between runs and machines and use the
+looser --cpu-threshold. Exits 1 when something moved beyond its threshold.
+"""
+
+import argparse
+import csv
+import sys
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return {(r["bench"], r["player"], r["param"], r["metric"]): (float(r["value"]), r["unit"])
+                for r in csv.DictReader(f)}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=2.0, help="percent, virtual-time metrics (default 2)")
+    ap.add_argument("--cpu-threshold", type=float, default=25.0, help="percent, ns metrics (default 25)")
+    ap.add_argument("--all", action="store_true", help="print unchanged rows too")
+    args = ap.parse_args()
+
+    base, cur = load(args.baseline), load(args.current)
+    changed = 0
+    print("bench,player,param,metric,baseline,current,delta_pct,flag")
+    for key in sorted(set(base) | set(cur)):
+        if key not in base or key not in cur:
+            print(",".join(key) + ",%s,%s,,%s" % (
+                base.get(key, ("",))[0], cur.get(key, ("",))[0], "added" if key in cur else "removed"))
+            continue
+        (b, unit), (c, _) = base[key], cur[key]
+        delta = (c - b) / abs(b) * 100.0 if b else (0.0 if c == b else float("inf"))
+        limit = args.cpu_threshold if unit == "ns" else args.threshold
+        flag = "CHANGED" if abs(delta) > limit else ""
+        changed += bool(flag)
+        if flag or args.all:
+            print(",".join(key) + ",%g,%g,%.1f,%s" % (b, c, delta, flag))
+    return 1 if changed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,536 @@
+// bench_main.cpp — host benchmarks for the PlayerController core.
+// Usage: ./build/player_bench [filter]   (filter = substring of the bench name)
+//
+// Prints one CSV row per measurement on stdout:
+//   bench,player,param,metric,value,unit
+// Rows are stable across runs (the clock is virtual, random() is seeded) except
+// the *_ns CPU timings; compare two runs with bench_compare.py.
+#include <Arduino.h>
+#include <chrono>
+#include <memory>
+#include "DebugLevelManager.h"
+#include "MDPlayerController.h"
+#include "PlayerPlaylist.h"
+#include "XYPlayerController.h"
+
+typedef std::unique_ptr<PlayerController> PlayerPtr;
+
+static PlayerPtr makePlayer(const char* name) {
+  PlayerPtr p;
+  if (strcmp(name, "XY") == 0) p.reset(new XYPlayerController(4, 5));
+  else                         p.reset(new MDPlayerController(4, 5));
+  hostsim::setSpinStepMicros(1);  // begin() paces with blocking spins
+  p->begin();
+  for (int i = 0; i < 200; ++i) { hostsim::advanceMillis(5); p->update(); }
+  p->resetCommandCounters();
+  p->resetLatencyHistograms();
+  p->clearTrace();
+  hostsim::setSpinStepMicros(0);  // exact virtual time from here on
+  return p;
+}
+
+static const char* const kPlayers[] = { "XY", "MD" };
+
+static void row(const char* bench, const char* player, const char* param,
+                const char* metric, double value, const char* unit) {
+  printf("%s,%s,%s,%s,%.3f,%s\n", bench, player, param, metric, value, unit);
+}
+
+static uint32_t sentCount(const PlayerController& p) {
+  uint32_t n = 0;
+  for (uint8_t t = 0; t < PLAYER_MAX_OPCODES; ++t) {
+    const PlayerLatencyHistogram* h = p.getPostToWireHistogram(t);
+    if (h) n += h->count;
+  }
+  return n;
+}
+
+// ── update() CPU time per call, per debug level ─────────────────────────────
+// A 1 ms loop that keeps a fade running, so update() does real work (fade
+// steps, queue flushes) and the FADE/COMMANDS prints fire. Serial output is
+// formatted but discarded.
+static void benchUpdateCost(const char* player) {
+  struct Level { const char* name; DebugLevel level; };
+  const Level levels[] = {
+    { "NONE",          DebugLevel::NONE },
+    { "COMMANDS",      DebugLevel::COMMANDS },
+    { "FADE",          DebugLevel::FADE },
+    { "REALTIME|FADE", DebugLevel::REALTIME | DebugLevel::FADE },
+    { "ALL",           DebugLevel::ALL },
+  };
+  const uint32_t calls = 200000;
+
+  Serial.setEcho(false);
+  for (const Level& lv : levels) {
+    PlayerPtr p = makePlayer(player);
+    p->setVolume(5);
+    CURRENT_DEBUG_LEVEL = lv.level;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+      if (!p->isFading()) p->fadeTo(PlayerController::MIN_FADE_DURATION_MS, p->getVolume() < 15 ? 25 : 5);
+      p->update();
+      hostsim::advanceMillis(1);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    CURRENT_DEBUG_LEVEL = DebugLevel::NONE;
+    row("update_cost", player, lv.name, "ns_per_call", ns / calls, "ns");
+    row("update_cost", player, lv.name, "sent_per_s", sentCount(*p) * 1000.0 / calls, "cmd/s");
+  }
+}
+
+// ── Command throughput under volume flooding ────────────────────────────────
+// A new volume is posted every postEveryMs; the backend's pacing decides how
+// many reach the wire. Coalescing turns the surplus into Merged.
+static void benchVolumeFlood(const char* player) {
+  const uint32_t postEvery[] = { 1, 5, 20, 100 };
+  const uint32_t runMs = 10000;
+  for (uint32_t every : postEvery) {
+    PlayerPtr p = makePlayer(player);
+    char param[24];
+    snprintf(param, sizeof(param), "post_every_%lums", (unsigned long)every);
+    uint32_t posted = 0;
+    for (uint32_t t = 0; t < runMs; ++t) {
+      if (t % every == 0) p->setVolume(5 + (int)(posted++ % 20));
+      p->update();
+      hostsim::advanceMillis(1);
+    }
+    const double secs = runMs / 1000.0;
+    row("volume_flood", player, param, "posted_per_s", posted / secs, "cmd/s");
+    row("volume_flood", player, param, "sent_per_s", sentCount(*p) / secs, "cmd/s");
+    row("volume_flood", player, param, "merged", p->getMergedCommandCount(), "cmd");
+    row("volume_flood", player, param, "dropped", p->getDroppedCommandCount(), "cmd");
+    row("volume_flood", player, param, "expired", p->getExpiredCommandCount(), "cmd");
+  }
+}
+
+// ── Fade duration error ─────────────────────────────────────────────────────
+// logic: fadeTo() until isFading() is false. wire: until the target volume is
+// in the shadow state, i.e. the last step has been written to the UART. Run
+// with a healthy 5 ms loop and a sluggish 150 ms one.
+static void benchFadeAccuracy(const char* player) {
+  typedef PlayerController::FadeCurve Curve;
+  struct Case { int from, to, durationMs; Curve curve; };
+  const Case cases[] = {
+    { 0, 30, 1400, Curve::LINEAR }, { 0, 30, 3000, Curve::LINEAR }, { 0, 30, 10000, Curve::LINEAR },
+    { 10, 20, 1400, Curve::LINEAR }, { 10, 20, 5000, Curve::LINEAR }, { 30, 0, 2000, Curve::LINEAR },
+    { 5, 6, 1400, Curve::LINEAR },
+    { 0, 30, 3000, Curve::LOGARITHMIC }, { 0, 30, 3000, Curve::EXPONENTIAL },
+    { 30, 0, 3000, Curve::S_CURVE }, { 30, 0, 3000, Curve::EQUAL_POWER },
+  };
+  static const char* const curveNames[] = { "linear", "log", "exp", "s", "eqpow" };
+  const uint32_t loopPeriods[] = { 5, 150 };
+  for (uint32_t loopMs : loopPeriods)
+  for (const Case& c : cases) {
+    PlayerPtr p = makePlayer(player);
+    p->setVolume(c.from);
+    for (int i = 0; i < 100; ++i) { p->update(); hostsim::advanceMillis(loopMs); }
+
+    char param[48];
+    snprintf(param, sizeof(param), "%d->%d_in_%dms_%s_loop_%lums", c.from, c.to, c.durationMs,
+             curveNames[(uint8_t)c.curve], (unsigned long)loopMs);
+    const uint32_t start = millis();
+    uint32_t logicMs = 0, wireMs = 0;
+    p->fadeTo(c.durationMs, c.to, c.curve);
+    while ((logicMs == 0 || wireMs == 0) && millis() - start < 4UL * c.durationMs + 5000) {
+      p->update();
+      uint16_t vol = 0;
+      if (logicMs == 0 && !p->isFading()) logicMs = millis() - start;
+      if (wireMs == 0 && p->getShadowState(PlayerStateKey::Volume, vol) && vol == c.to && !p->isFading()) {
+        wireMs = millis() - start;
+      }
+      hostsim::advanceMillis(loopMs);
+    }
+    row("fade_accuracy", player, param, "logic_ms", logicMs, "ms");
+    row("fade_accuracy", player, param, "wire_ms", wireMs, "ms");
+    row("fade_accuracy", player, param, "wire_error_pct",
+        100.0 * ((double)wireMs - c.durationMs) / c.durationMs, "%");
+  }
+}
+
+// ── Fade retargeting ────────────────────────────────────────────────────────
+// A 0->30 fade over 3000 ms is retargeted at 1000 ms (reversing to 5 over
+// 1400 ms). max_jump: largest volume change between consecutive frames on the
+// wire; end_ms: when the new target was sent (requested: 2400 ms).
+static void benchFadeRetarget(const char* player) {
+  PlayerPtr p = makePlayer(player);
+  p->setVolume(0);
+  for (int i = 0; i < 100; ++i) { p->update(); hostsim::advanceMillis(5); }
+
+  const uint32_t start = millis();
+  p->fadeTo(3000, 30);
+  uint16_t last = 0, vol = 0;
+  uint32_t maxJump = 0, endMs = 0;
+  bool retargeted = false;
+  while (endMs == 0 && millis() - start < 6000) {
+    if (!retargeted && millis() - start >= 1000) { p->fadeTo(1400, 5); retargeted = true; }
+    p->update();
+    if (p->getShadowState(PlayerStateKey::Volume, vol)) {
+      const uint32_t jump = vol > last ? vol - last : last - vol;
+      if (jump > maxJump) maxJump = jump;
+      last = vol;
+      if (retargeted && vol == 5 && !p->isFading()) endMs = millis() - start;
+    }
+    hostsim::advanceMillis(5);
+  }
+  row("fade_retarget", player, "0->30_then_5_at_1000ms", "max_jump", maxJump, "vol");
+  row("fade_retarget", player, "0->30_then_5_at_1000ms", "end_ms", endMs, "ms");
+  row("fade_retarget", player, "0->30_then_5_at_1000ms", "retargets", p->getFadeRetargetCount(), "count");
+}
+
+// ── Envelope playback ───────────────────────────────────────────────────────
+// Swell, hold, dip, recover, started with a track. For each breakpoint: the
+// volume on the wire when it is due (err_vol) and how late that volume got
+// there (late_ms).
+static void benchEnvelope(const char* player) {
+  static PlayerEnvelope env;
+  env.clear();
+  env.add(   0,  0);
+  env.add(1500, 25, PlayerFadeCurve::S_CURVE);
+  env.add(3000, 25);
+  env.add(3500, 10, PlayerFadeCurve::EXPONENTIAL);
+  env.add(5000, 10);
+  env.add(6000, 25, PlayerFadeCurve::LOGARITHMIC);
+
+  PlayerPtr p = makePlayer(player);
+  p->startEnvelope(env, PlayerController::EnvelopeStart::ON_PLAY);
+  p->playTrack(2, 60000, "bench");
+  const uint32_t sentBefore = sentCount(*p);
+  uint32_t start = 0;
+  uint32_t reachedAt[PlayerEnvelope::CAPACITY] = {};
+  int wireAtDue[PlayerEnvelope::CAPACITY];
+  for (uint8_t i = 0; i < env.count(); ++i) wireAtDue[i] = -1;
+  const uint32_t begin = millis();
+  while (millis() - begin < 8000) {
+    p->update();
+    uint16_t vol = 0;
+    p->getShadowState(PlayerStateKey::Volume, vol);
+    if (start == 0 && sentCount(*p) != sentBefore) start = millis();  // play is out
+    for (uint8_t i = 0; start && i < env.count(); ++i) {
+      const uint32_t t = millis() - start;
+      if (wireAtDue[i] < 0 && t >= env.point(i).atMs) wireAtDue[i] = vol;
+      if (!reachedAt[i] && t >= env.point(i).atMs && vol == env.point(i).volume) reachedAt[i] = t;
+    }
+    hostsim::advanceMillis(5);
+  }
+  for (uint8_t i = 1; i < env.count(); ++i) {
+    char param[24];
+    snprintf(param, sizeof(param), "point%u_%lums", i, (unsigned long)env.point(i).atMs);
+    row("envelope", player, param, "err_vol", wireAtDue[i] - env.point(i).volume, "vol");
+    row("envelope", player, param, "late_ms", reachedAt[i] ? reachedAt[i] - env.point(i).atMs : 9999, "ms");
+  }
+}
+
+// ── fadeIn() start ──────────────────────────────────────────────────────────
+// call_us: virtual time spent inside fadeIn() (the clock advances 1 µs per
+// read, so a busy-wait shows up here). ramp_start_ms: from the call to the
+// first fade step on the wire. total_ms: until the target volume is sent.
+static void benchFadeInStart(const char* player) {
+  PlayerPtr p = makePlayer(player);
+  hostsim::setSpinStepMicros(1);
+  const int durationMs = 2000, target = 20;
+  const uint64_t t0 = hostsim::nowMicros();
+  p->fadeIn(durationMs, target, 3, 60000, "bench");
+  const double callUs = (double)(hostsim::nowMicros() - t0);
+  hostsim::setSpinStepMicros(0);
+
+  const uint32_t start = millis();
+  uint32_t rampMs = 0, totalMs = 0;
+  while (totalMs == 0 && millis() - start < 10000) {
+    p->update();
+    uint16_t vol = 0;
+    const bool known = p->getShadowState(PlayerStateKey::Volume, vol);
+    if (rampMs == 0 && known && vol > 0) rampMs = millis() - start;
+    if (known && vol == target) totalMs = millis() - start;
+    hostsim::advanceMillis(5);
+  }
+  row("fadein_start", player, "0->20_in_2000ms", "call_us", callUs, "us");
+  row("fadein_start", player, "0->20_in_2000ms", "ramp_start_ms", rampMs, "ms");
+  row("fadein_start", player, "0->20_in_2000ms", "total_ms", totalMs, "ms");
+}
+
+// ── schedulePlay firing jitter vs loop period ───────────────────────────────
+// Arms schedulePlay at a random phase relative to the loop and records how late
+// it fires (update() noticed it) and how late the play frame reaches the wire.
+// Lateness is against the compensated instant: the play is meant to go out
+// getPlayStartLatencyMs() before the countdown ends.
+static void benchScheduleJitter(const char* player) {
+  const uint32_t loopPeriods[] = { 1, 5, 10, 20, 50 };
+  const int trials = 100;
+  randomSeed(12345);
+  for (uint32_t period : loopPeriods) {
+    PlayerPtr p = makePlayer(player);
+    double sumFire = 0, sumWire = 0;
+    uint32_t maxFire = 0, maxWire = 0;
+    for (int i = 0; i < trials; ++i) {
+      hostsim::advanceMicros((uint32_t)random(0, (long)period * 1000));
+      const uint32_t countdown = 500 + (uint32_t)random(0, 500);
+      const uint32_t due = millis() + countdown - p->getPlayStartLatencyMs();
+      p->schedulePlay(1 + i % 5, 300, "bench", -1, countdown);
+
+      uint32_t fired = 0, wired = 0;
+      const uint32_t sentBefore = sentCount(*p);
+      while (wired == 0 && (int32_t)(millis() - due) < 2000) {
+        hostsim::advanceMillis(period);
+        p->update();
+        if (fired == 0 && !p->hasScheduledPlay()) fired = millis();
+        if (fired != 0 && sentCount(*p) != sentBefore) wired = millis();
+      }
+      const uint32_t fireLate = fired - due, wireLate = wired - due;
+      sumFire += fireLate; sumWire += wireLate;
+      if (fireLate > maxFire) maxFire = fireLate;
+      if (wireLate > maxWire) maxWire = wireLate;
+      // Let the track end and the link go quiet before the next trial.
+      for (uint32_t t = 0; t < 600; t += period) { hostsim::advanceMillis(period); p->update(); }
+    }
+    char param[20];
+    snprintf(param, sizeof(param), "loop_%lums", (unsigned long)period);
+    row("schedule_jitter", player, param, "fire_late_mean_ms", sumFire / trials, "ms");
+    row("schedule_jitter", player, param, "fire_late_max_ms", maxFire, "ms");
+    row("schedule_jitter", player, param, "wire_late_mean_ms", sumWire / trials, "ms");
+    row("schedule_jitter", player, param, "wire_late_max_ms", maxWire, "ms");
+  }
+}
+
+// ── Pre-rolled schedulePlay ─────────────────────────────────────────────────
+// schedulePlay(..., preRoll = true) at a 5 ms loop: how late the volume
+// restore (the audible start) reaches the wire after the scheduled time.
+static void benchPreRoll(const char* player) {
+  const uint32_t period = 5;
+  const int trials = 100;
+  randomSeed(12345);
+  PlayerPtr p = makePlayer(player);
+  p->setVolume(20);
+  double sum = 0;
+  uint32_t maxLate = 0;
+  for (int i = 0; i < trials; ++i) {
+    hostsim::advanceMicros((uint32_t)random(0, (long)period * 1000));
+    const uint32_t countdown = 500 + (uint32_t)random(0, 500);
+    const uint32_t due = millis() + countdown;
+    p->schedulePlay(1 + i % 5, 300, "bench", -1, countdown, /*preRoll=*/true);
+
+    // The restore usually goes out in the update() that fires it.
+    uint32_t fired = 0, wired = 0, sentAtFire = 0;
+    while (wired == 0 && (int32_t)(millis() - due) < 2000) {
+      hostsim::advanceMillis(period);
+      const uint32_t sentBefore = sentCount(*p);
+      p->update();
+      if (fired == 0 && !p->hasScheduledPlay()) { fired = millis(); sentAtFire = sentBefore; }
+      if (fired != 0 && sentCount(*p) != sentAtFire) wired = millis();
+    }
+    const uint32_t late = wired - due;
+    sum += late;
+    if (late > maxLate) maxLate = late;
+    for (uint32_t t = 0; t < 600; t += period) { hostsim::advanceMillis(period); p->update(); }
+  }
+  char param[24];
+  snprintf(param, sizeof(param), "preroll_%ums", (unsigned)p->getPreRollMs());
+  row("preroll", player, param, "unmute_late_mean_ms", sum / trials, "ms");
+  row("preroll", player, param, "unmute_late_max_ms", maxLate, "ms");
+}
+
+// ── Track to track ──────────────────────────────────────────────────────────
+// A 1000 ms track followed by another, per loop period: the sketch polling
+// isSoundPlaying() and playing the next one, against queueNextTrack(). The
+// gap is from the end of the first track to the next play frame on the wire
+// plus the play-start latency, i.e. when the second sound is heard.
+static void benchNextTrack(const char* player) {
+  const uint32_t loopPeriods[] = { 1, 10, 50 };
+  const int trials = 20;
+  for (uint32_t period : loopPeriods) {
+    for (int queued = 0; queued <= 1; ++queued) {
+      PlayerPtr p = makePlayer(player);
+      double sum = 0;
+      int32_t maxGap = INT32_MIN;
+      for (int i = 0; i < trials; ++i) {
+        p->playTrack(1, 1000, "first");
+        for (uint32_t t = 0; t < 300; t += period) { hostsim::advanceMillis(period); p->update(); }
+        const uint32_t end = millis() - 300 + 1000;  // playTrack() stamped the start
+        if (queued) p->queueNextTrack(2, 1000, "second");
+
+        uint32_t wired = 0;
+        while (wired == 0 && (int32_t)(millis() - end) < 2000) {
+          hostsim::advanceMillis(period);
+          const uint32_t sentBefore = sentCount(*p);
+          p->update();
+          if (!queued && !p->isSoundPlaying()) p->playTrack(2, 1000, "second");
+          if (p->isSoundPlaying() && p->getCurrentTrack() == 2 && sentCount(*p) != sentBefore) wired = millis();
+        }
+        const int32_t gap = (int32_t)(wired + p->getPlayStartLatencyMs() - end);
+        sum += gap;
+        if (gap > maxGap) maxGap = gap;
+        p->stop();
+        for (uint32_t t = 0; t < 600; t += period) { hostsim::advanceMillis(period); p->update(); }
+      }
+      char param[24];
+      snprintf(param, sizeof(param), "loop_%lums", (unsigned long)period);
+      row("next_track", player, param, queued ? "queued_gap_mean_ms" : "poll_gap_mean_ms", sum / trials, "ms");
+      row("next_track", player, param, queued ? "queued_gap_max_ms" : "poll_gap_max_ms", maxGap, "ms");
+    }
+  }
+}
+
+// ── Playlist selection ──────────────────────────────────────────────────────
+// Draw cost per mode over 30 tracks, and what each mode promises: no repeat
+// inside a shuffle bag or across its refill, at least avoidLast other tracks
+// between repeats, weighted frequencies within a few percent of weight / sum.
+// Then a shuffled playlist played through queueNextTrack() for 60 s: tracks
+// started and loop ticks with nothing playing (the hand-offs).
+static bool benchResolve(int track, unsigned long& durationMs, const char*& trackName, void*) {
+  durationMs = 1000 + (track % 3) * 500;
+  trackName = "bench";
+  return true;
+}
+
+static void benchPlaylist(const char* player) {
+  PlayerPtr p = makePlayer(player);
+  PlayerPlaylist list(*p);
+  list.setRange(1, 30);
+  randomSeed(4242);
+  const uint32_t draws = 300000;
+
+  struct ModeCase { const char* name; PlayerPlaylist::Mode mode; uint8_t avoid; };
+  const ModeCase cases[] = {
+    { "sequential",   PlayerPlaylist::Mode::SEQUENTIAL,   0 },
+    { "shuffle",      PlayerPlaylist::Mode::SHUFFLE,      0 },
+    { "weighted",     PlayerPlaylist::Mode::WEIGHTED,     0 },
+    { "avoid_last_8", PlayerPlaylist::Mode::AVOID_RECENT, 8 },
+  };
+  for (const ModeCase& c : cases) {
+    for (uint8_t i = 0; i < list.size(); ++i) list.setWeight(i, 1 + i % 8);
+    list.setMode(c.mode, c.avoid);
+    uint32_t count[31] = {}, lastSeen[31] = {};
+    uint32_t bagRepeats = 0, minDistance = UINT32_MAX;
+    uint32_t bagSeen = 0;  // bitmask of the current bag (shuffle)
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 1; n <= draws; ++n) {
+      const int track = list.next();
+      count[track]++;
+      if (lastSeen[track] && n - lastSeen[track] < minDistance) minDistance = n - lastSeen[track];
+      lastSeen[track] = n;
+      if (c.mode == PlayerPlaylist::Mode::SHUFFLE) {
+        if (bagSeen & (1UL << track)) bagRepeats++;
+        bagSeen |= 1UL << track;
+        if ((n % 30) == 0) bagSeen = 0;
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    row("playlist", player, c.name, "draw_ns", ns / draws, "ns");
+    row("playlist", player, c.name, "min_repeat_distance", minDistance, "draws");
+    if (c.mode == PlayerPlaylist::Mode::SHUFFLE) row("playlist", player, c.name, "bag_repeats", bagRepeats, "count");
+    if (c.mode == PlayerPlaylist::Mode::WEIGHTED) {
+      double worst = 0;
+      uint32_t weightSum = 0;
+      for (uint8_t i = 0; i < 30; ++i) weightSum += 1 + i % 8;
+      for (int t = 1; t <= 30; ++t) {
+        const double expected = (double)draws * (1 + (t - 1) % 8) / weightSum;
+        worst = std::max(worst, fabs(count[t] - expected) / expected * 100.0);
+      }
+      row("playlist", player, c.name, "freq_err_max_pct", worst, "%");
+    }
+  }
+
+  // Playback through the gapless queue.
+  list.setMode(PlayerPlaylist::Mode::SHUFFLE);
+  list.setResolver(benchResolve);
+  list.start();
+  uint32_t started = 1, idleTicks = 0;
+  int lastTrack = p->getCurrentTrack();
+  for (uint32_t t = 0; t < 60000; t += 5) {
+    hostsim::advanceMillis(5);
+    p->update();
+    list.update();
+    if (!p->isSoundPlaying()) idleTicks++;
+    if (p->getCurrentTrack() != lastTrack) { started++; lastTrack = p->getCurrentTrack(); }
+  }
+  list.stop();
+  row("playlist", player, "shuffle_60s", "tracks_started", started, "count");
+  row("playlist", player, "shuffle_60s", "idle_ticks", idleTicks, "count");
+}
+
+// ── Scheduled-action timeline ───────────────────────────────────────────────
+// update() cost with 0..PLAYER_TIMELINE_SIZE far-future entries pending (only
+// the head is looked at), the cost of a schedule+cancel pair on a full
+// timeline, and a shuffled cue list of volume changes with every other cue
+// cancelled: each kept cue must fire once, in time order, within one loop.
+static void benchTimeline(const char* player) {
+  const uint32_t calls = 200000;
+  const uint8_t depths[] = { 0, 4, PLAYER_TIMELINE_SIZE - 1 };
+  for (uint8_t depth : depths) {
+    PlayerPtr p = makePlayer(player);
+    for (uint8_t i = 0; i < depth; ++i) p->scheduleVolume(i % 30, 3600000UL + i * 1000UL);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; ++i) { p->update(); hostsim::advanceMillis(1); }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    char param[20];
+    snprintf(param, sizeof(param), "pending_%u", (unsigned)depth);
+    row("timeline", player, param, "update_ns_per_call", ns / calls, "ns");
+
+    if (depth == PLAYER_TIMELINE_SIZE - 1) {
+      const uint32_t pairs = 200000;
+      const auto t1 = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < pairs; ++i) p->cancelScheduled(p->scheduleVolume(1, 1800000UL + (i % 97) * 1000UL));
+      const double pairNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t1).count();
+      row("timeline", player, param, "schedule_cancel_ns", pairNs / pairs, "ns");
+    }
+  }
+
+  // Cue list: volumes 1..N at 100 ms + k * 40 ms, scheduled in shuffled order.
+  const uint8_t cues = PLAYER_TIMELINE_SIZE;
+  const uint32_t period = 5;
+  randomSeed(4242);
+  PlayerPtr p = makePlayer(player);
+  p->setVolume(0);
+  uint8_t order[cues];
+  for (uint8_t i = 0; i < cues; ++i) order[i] = i;
+  for (uint8_t i = cues - 1; i > 0; --i) { const uint8_t j = (uint8_t)random(0, i + 1); uint8_t t = order[i]; order[i] = order[j]; order[j] = t; }
+  const uint32_t start = millis();
+  PlayerController::ScheduleHandle handles[cues];
+  for (uint8_t i = 0; i < cues; ++i) handles[order[i]] = p->scheduleVolume(1 + order[i], 100 + order[i] * 40UL);
+  for (uint8_t k = 1; k < cues; k += 2) p->cancelScheduled(handles[k]);
+
+  uint8_t next = 0, fired = 0, orderErrors = 0;
+  uint32_t maxLate = 0;
+  int lastVolume = p->getVolume();
+  while (millis() - start < 200 + cues * 40UL) {
+    hostsim::advanceMillis(period);
+    p->update();
+    if (p->getVolume() == lastVolume) continue;
+    lastVolume = p->getVolume();
+    fired++;
+    if (lastVolume != 1 + next) orderErrors++;
+    const uint32_t late = millis() - (start + 100 + next * 40UL);
+    if (late > maxLate) maxLate = late;
+    next += 2;
+  }
+  row("timeline", player, "cues_16_half_cancelled", "fired", fired, "count");
+  row("timeline", player, "cues_16_half_cancelled", "order_errors", orderErrors, "count");
+  row("timeline", player, "cues_16_half_cancelled", "fire_late_max_ms", maxLate, "ms");
+  row("timeline", player, "cues_16_half_cancelled", "left_pending", p->getScheduledCount(), "count");
+}
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : "";
+  Serial.setEcho(false);
+
+  struct Bench { const char* name; void (*fn)(const char*); };
+  const Bench benches[] = {
+    { "update_cost",     benchUpdateCost },
+    { "volume_flood",    benchVolumeFlood },
+    { "fade_accuracy",   benchFadeAccuracy },
+    { "fade_retarget",   benchFadeRetarget },
+    { "fadein_start",    benchFadeInStart },
+    { "envelope",        benchEnvelope },
+    { "schedule_jitter", benchScheduleJitter },
+    { "preroll",         benchPreRoll },
+    { "next_track",      benchNextTrack },
+    { "playlist",        benchPlaylist },
+    { "timeline",        benchTimeline },
+  };
+
+  printf("bench,player,param,metric,value,unit\n");
+  for (const Bench& b : benches) {
+    if (!strstr(b.name, filter)) continue;
+    for (const char* player : kPlayers) b.fn(player);
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+// mailbox_stress_main.cpp
+//
+// Stress test for PlayerCommandMailbox: N producer threads post numbered
+// commands as fast as they can, one consumer thread drains them. Every payload
+// encodes (producer, sequence) plus a check word, so the consumer can tell a
+// lost, duplicated, reordered (per producer) or torn/corrupted entry apart.
+// Exits 1 if any run saw one of them.
+//
+//   ./build/player_mailbox_stress                 # 4 producers, 200000 posts each
+//   ./build/player_mailbox_stress 8 1000000       # producers, posts per producer
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "PlayerCommandMailbox.h"
+
+namespace {
+
+// type = producer, a = sequence (mod 65536), b = check word over both.
+uint16_t checkWord(uint8_t producer, uint16_t seq) {
+  uint32_t x = ((uint32_t)producer << 16) | seq;
+  x ^= x >> 15; x *= 0x2C1B3C6DU; x ^= x >> 12;
+  return (uint16_t)(x ^ (x >> 16));
+}
+
+struct Result {
+  unsigned long received = 0, lost = 0, duplicated = 0, reordered = 0, corrupted = 0;
+  unsigned long fullRetries = 0;
+  double wallMs = 0;
+  bool ok() const { return lost == 0 && duplicated == 0 && reordered == 0 && corrupted == 0; }
+};
+
+template <uint8_t N, bool MultiProducer>
+Result run(unsigned producers, unsigned long perProducer) {
+  PlayerCommandMailbox<N, MultiProducer> mailbox;
+  std::atomic<unsigned> done { 0 };
+  std::atomic<unsigned long> fullRetries { 0 };
+  std::atomic<bool> go { false };
+  Result r;
+
+  std::vector<std::thread> threads;
+  for (unsigned p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      unsigned long retries = 0;
+      for (unsigned long i = 0; i < perProducer; ++i) {
+        const uint16_t seq = (uint16_t)i;
+        while (!mailbox.post((uint8_t)p, seq, checkWord((uint8_t)p, seq))) {
+          ++retries;
+          std::this_thread::yield();
+        }
+      }
+      fullRetries.fetch_add(retries, std::memory_order_relaxed);
+      done.fetch_add(1, std::memory_order_release);
+    });
+  }
+
+  // Consumer: the expected next sequence per producer. Since the sequence is
+  // 16 bits, a skip is told from a duplicate by how far behind it is.
+  std::vector<unsigned long> expected(producers, 0);
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (;;) {
+    uint8_t type; uint16_t a, b;
+    if (!mailbox.take(type, a, b)) {
+      if (done.load(std::memory_order_acquire) == producers && mailbox.empty()) break;
+      std::this_thread::yield();
+      continue;
+    }
+    ++r.received;
+    if (type >= producers || b != checkWord(type, a)) {
+      if (r.corrupted++ < 5) printf("  corrupted: type %u a %u b %04X\n", (unsigned)type, (unsigned)a, (unsigned)b);
+      continue;
+    }
+    const uint16_t want = (uint16_t)expected[type];
+    const int16_t  diff = (int16_t)(a - want);
+    if (diff == 0) {
+      ++expected[type];
+    } else if (diff < 0) {
+      if (r.duplicated++ < 5) printf("  duplicated/old: producer %u seq %u, expected %u\n", (unsigned)type, (unsigned)a, (unsigned)want);
+    } else {
+      if (r.reordered++ < 5) printf("  out of order: producer %u seq %u, expected %u\n", (unsigned)type, (unsigned)a, (unsigned)want);
+      expected[type] += (unsigned long)diff + 1;  // resync past the gap
+    }
+  }
+  for (std::thread& t : threads) t.join();
+  r.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  r.fullRetries = fullRetries.load();
+
+  // Every post arrives exactly once: whatever is missing beyond the
+  // duplicates and corrupted entries never came out of the mailbox.
+  const unsigned long posted = (unsigned long)producers * perProducer;
+  const unsigned long unique = r.received - r.duplicated - r.corrupted;
+  if (unique < posted) r.lost = posted - unique;
+  return r;
+}
+
+bool report(const char* name, unsigned producers, unsigned long perProducer, const Result& r) {
+  printf("%-22s producers %2u  posts %9lu  received %9lu  lost %lu  dup %lu  reordered %lu  corrupted %lu  full-retries %lu  %.0f ms  %s\n",
+         name, producers, (unsigned long)producers * perProducer, r.received, r.lost, r.duplicated, r.reordered,
+         r.corrupted, r.fullRetries, r.wallMs, r.ok() ? "OK" : "FAIL");
+  return r.ok();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const unsigned      producers   = argc > 1 ? (unsigned)atoi(argv[1]) : 4;
+  const unsigned long perProducer = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200000UL;
+  if (producers == 0 || producers > 255 || perProducer == 0) {
+    fprintf(stderr, "usage: %s [producers 1..255] [posts per producer]\n", argv[0]);
+    return 2;
+  }
+
+  bool ok = true;
+  // A small ring is full most of the time (the CAS and wrap paths); a large
+  // one runs near empty. N=8 is PLAYER_CMD_MAILBOX_SIZE's default.
+  ok &= report("mpsc N=4",  producers, perProducer, run<4,  true>(producers, perProducer));
+  ok &= report("mpsc N=8",  producers, perProducer, run<8,  true>(producers, perProducer));
+  ok &= report("mpsc N=64", producers, perProducer, run<64, true>(producers, perProducer));
+  // MultiProducer = false is only valid with one producer.
+  ok &= report("spsc N=8",  1, perProducer, run<8,  false>(1, perProducer));
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
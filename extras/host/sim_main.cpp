@@ -0,0 +1,53 @@
+// sim_main.cpp — runs an XY player through a short show at virtual time and
+// prints what went out on its UART. Usage: ./build/player_sim [-v]
+//   -v  echo the library's Serial output (wire logs, debug prints)
+#include <Arduino.h>
+#include <chrono>
+#include "XYPlayerController.h"
+
+static void runFor(PlayerController& player, uint32_t ms, uint32_t tickMs) {
+  const uint32_t end = millis() + ms;
+  while ((int32_t)(millis() - end) < 0) {
+    player.update();
+    hostsim::advanceMillis(tickMs);
+  }
+}
+
+static void printFrames(const std::string& tx) {
+  // XY frames: 0xAA cmd len data... checksum
+  size_t i = 0;
+  while (i + 2 < tx.size()) {
+    const size_t len = 4 + (uint8_t)tx[i + 2];
+    printf("  ");
+    for (size_t j = 0; j < len && i + j < tx.size(); ++j) printf("%02X ", (uint8_t)tx[i + j]);
+    printf("\n");
+    i += len;
+  }
+}
+
+int main(int argc, char** argv) {
+  const bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  Serial.setEcho(verbose);
+
+  const auto wallStart = std::chrono::steady_clock::now();
+
+  XYPlayerController player(/*rxPin=*/4, /*txPin=*/5);
+  hostsim::FakeUart* uart = hostsim::lastUart();
+  player.begin();
+  player.setVolume(10);
+  player.playTrack(1, 4000, "intro");
+  player.fadeTo(PlayerController::MIN_FADE_DURATION_MS, 25);
+  runFor(player, 2000, 5);
+  player.fadeOut(PlayerController::MIN_FADE_DURATION_MS, 0, true);
+  runFor(player, 3000, 5);
+
+  const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+  Serial.setEcho(true);
+  printf("UART frames (%zu bytes):\n", uart->tx().size());
+  printFrames(uart->tx());
+  player.printLatencyHistograms(Serial);
+  player.dumpTrace(Serial);
+  printf("virtual %lu ms in %.1f ms wall time\n", (unsigned long)millis(), wallMs);
+  return 0;
+}
@@ -0,0 +1,167 @@
+// sync_main.cpp — multi-node start alignment over loopback UDP.
+// Usage: ./build/player_sync_sim [nodes] [max_skew_ppm] [cues]   (defaults 24 200 5)
+//
+// Every node is a thread with its own XY controller, HostUdp socket and
+// PlayerClockSync, and a local clock with a random boot offset (0..10 s) and
+// crystal skew (±max_skew_ppm) injected through hostsim::setThreadClock().
+// Node 0 is the clock master and also plays. Time is real (steady clock).
+//
+// For each cue the master picks a start 1000 ms ahead on its clock; the cue
+// reaches each node 0..300 ms later (simulated show-network jitter). The
+// first cue uses the plain countdown (schedulePlay(countdown) on arrival, the
+// behaviour without clock sync), the rest use PlayerClockSync::schedulePlayAt.
+// The spread is the true-time difference between the first and last node
+// firing its scheduled play.
+#include <Arduino.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "DebugLevelManager.h"
+#include "HostUdp.h"
+#include "PlayerClockSync.h"
+#include "XYPlayerController.h"
+
+static const uint32_t CUE_LEAD_MS   = 1000;
+static const uint32_t CUE_JITTER_MS = 300;
+
+struct Node {
+  XYPlayerController player { 4, 5 };
+  HostUdp            udp;
+  PlayerClockSync    sync { udp };
+  int64_t            offsetUs = 0;
+  int32_t            skewPpm = 0;
+
+  // Cue handed over by the master thread: shared start, countdown as sent,
+  // true time it arrives here. cueId changes last (release).
+  std::atomic<uint32_t> cueSharedMs { 0 };
+  std::atomic<uint32_t> cueCountdownMs { 0 };
+  std::atomic<uint64_t> cueArriveUs { 0 };
+  std::atomic<bool>     cueNaive { false };
+  std::atomic<int>      cueId { 0 };
+
+  std::atomic<uint64_t> firedUs { 0 };   // true time the scheduled play fired
+  std::atomic<bool>     synced { false };
+};
+
+static std::atomic<bool> g_stop { false };
+static std::atomic<int>  g_cueRequest { 0 };   // main -> master: issue cue n
+static std::atomic<bool> g_cueNaive { false };
+
+static void runNode(std::vector<std::unique_ptr<Node>>& nodes, size_t index, uint16_t masterPort) {
+  Node& n = *nodes[index];
+  hostsim::setThreadClock(n.offsetUs, n.skewPpm);
+  n.player.begin();
+  if (index == 0) n.sync.beginMaster(masterPort);
+  else            n.sync.beginClient(IPAddress(127, 0, 0, 1), masterPort);
+
+  int cueSeen = 0, cueIssued = 0;
+  PlayerController::ScheduleHandle handle = 0;
+  while (!g_stop) {
+    n.sync.update();
+    n.synced = n.sync.isSynced();
+
+    // Master: publish a requested cue to every node, each with its own delay.
+    if (index == 0 && g_cueRequest != cueIssued) {
+      cueIssued = g_cueRequest;
+      const uint32_t at = n.sync.sharedMillis() + CUE_LEAD_MS;
+      const uint64_t now = hostsim::nowMicros();
+      for (size_t i = 0; i < nodes.size(); ++i) {
+        Node& m = *nodes[i];
+        m.cueSharedMs = at;
+        m.cueCountdownMs = CUE_LEAD_MS;
+        m.cueArriveUs = now + (uint64_t)(rand() % (CUE_JITTER_MS * 1000));
+        m.cueNaive = g_cueNaive.load();
+        m.firedUs = 0;
+        m.cueId.store(cueIssued, std::memory_order_release);
+      }
+    }
+
+    // Cue arrival: schedule the play.
+    if (n.cueId.load(std::memory_order_acquire) != cueSeen && hostsim::nowMicros() >= n.cueArriveUs) {
+      cueSeen = n.cueId;
+      handle = n.cueNaive ? n.player.schedulePlay(1, 500, "cue", -1, n.cueCountdownMs)
+                          : n.sync.schedulePlayAt(n.player, n.cueSharedMs, 1, 500, "cue");
+    }
+
+    n.player.update();
+    if (handle != 0 && !n.player.isScheduled(handle)) {
+      n.firedUs = hostsim::nowMicros();
+      handle = 0;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+int main(int argc, char** argv) {
+  const int    nodeCount = argc > 1 ? atoi(argv[1]) : 24;
+  const int    maxSkew   = argc > 2 ? atoi(argv[2]) : 200;
+  const int    cues      = argc > 3 ? atoi(argv[3]) : 5;
+  const uint16_t masterPort = (uint16_t)(47000 + getpid() % 1000);
+
+  Serial.setEcho(false);
+  CURRENT_DEBUG_LEVEL = DebugLevel::NONE;
+  hostsim::useRealTime(true);
+  srand(777);
+
+  std::vector<std::unique_ptr<Node>> nodes;
+  for (int i = 0; i < nodeCount; ++i) {
+    nodes.emplace_back(new Node());
+    nodes.back()->offsetUs = (int64_t)(rand() % 10000) * 1000;
+    nodes.back()->skewPpm  = maxSkew ? rand() % (2 * maxSkew + 1) - maxSkew : 0;
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nodeCount; ++i) threads.emplace_back(runNode, std::ref(nodes), (size_t)i, masterPort);
+
+  printf("%d nodes, boot offsets 0..10 s, skew up to ±%d ppm, cue lead %lu ms, delivery jitter 0..%lu ms\n",
+         nodeCount, maxSkew, (unsigned long)CUE_LEAD_MS, (unsigned long)CUE_JITTER_MS);
+
+  // Wait for every client to have offset and drift.
+  const uint64_t syncStart = hostsim::nowMicros();
+  for (;;) {
+    int synced = 0;
+    for (auto& n : nodes) synced += n->synced;
+    if (synced == nodeCount) break;
+    if (hostsim::nowMicros() - syncStart > 20000000ULL) {
+      printf("only %d/%d nodes synced after 20 s\n", synced, nodeCount);
+      g_stop = true;
+      for (auto& t : threads) t.join();
+      return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  printf("all nodes synced after %.1f s\n", (hostsim::nowMicros() - syncStart) / 1e6);
+
+  double worstSynced = 0;
+  for (int c = 0; c <= cues; ++c) {
+    g_cueNaive = (c == 0);
+    g_cueRequest = c + 1;
+    std::this_thread::sleep_for(std::chrono::milliseconds(CUE_LEAD_MS + CUE_JITTER_MS + 300));
+
+    uint64_t first = UINT64_MAX, last = 0;
+    int fired = 0;
+    for (auto& n : nodes) {
+      const uint64_t t = n->firedUs;
+      if (t == 0) continue;
+      fired++;
+      first = std::min(first, t);
+      last = std::max(last, t);
+    }
+    const double spreadMs = fired ? (last - first) / 1000.0 : -1;
+    printf("cue %d  %-7s fired %2d/%d  spread %8.3f ms\n", c, c == 0 ? "naive" : "synced", fired, nodeCount, spreadMs);
+    if (c > 0) worstSynced = fired == nodeCount ? std::max(worstSynced, spreadMs) : 1e9;
+  }
+
+  g_stop = true;
+  for (auto& t : threads) t.join();
+
+  // A node running fast by s ppm relative to the master needs drift -s.
+  printf("\nper node: expected / estimated drift (ppm), last round-trip delay\n");
+  for (int i = 1; i < nodeCount; ++i) {
+    printf("  node %2d  %+5d / %+8.2f   %lu us\n", i, (int)nodes[0]->skewPpm - (int)nodes[i]->skewPpm,
+           nodes[i]->sync.getDriftPpm(), (unsigned long)nodes[i]->sync.getLastDelayMicros());
+  }
+  printf("\nworst synced spread: %.3f ms\n", worstSynced);
+  return worstSynced <= 5.0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Decode a PlayerController command trace (PlayerController::dumpTrace()).
+
+Capture the serial output of a sketch that calls dumpTrace(Serial), then:
+
+    python3 trace_decode.py capture.log              # CSV on stdout
+    python3 trace_decode.py --timeline capture.log   # readable timeline
+    pio device monitor | python3 trace_decode.py -   # stream from stdin
+
+Anything outside "#PTRACE" ... "#END" blocks is ignored, so a raw serial
+log with other output mixed in works as input.
+"""
+
+import argparse
+import struct
+import sys
+
+# Must match PlayerCommandStatus in BauklankPlayerController.h.
+STATUS = ["Sent", "Merged", "Superseded", "Elided", "Unchanged", "Expired"]
+
+# Record layout per "#PTRACE <version>"; version 1 had no b (decoded as 0).
+# v2: postMs:4 sendDeltaMs:2 gapMs:2 a:2 b:2 type:1 status:1 queueDepth:1
+RECORD_V1 = struct.Struct("<IHHHBBB")
+RECORD_V2 = struct.Struct("<IHHHHBBB")
+
+
+def unpack(version, raw):
+    """(post, delta, gap, a, b, op, status, depth), or None on a size mismatch."""
+    record = RECORD_V1 if version == 1 else RECORD_V2
+    if len(raw) != record.size:
+        return None
+    fields = record.unpack(raw)
+    return fields[:4] + (0,) + fields[4:] if version == 1 else fields
+
+
+def parse(lines):
+    """Yields (header, opnames, records) for every complete trace block."""
+    header, ops, records, version = None, {}, [], 2
+    for line in lines:
+        line = line.strip()
+        if line.startswith("#PTRACE"):
+            header, ops, records = line, {}, []
+            parts = line.split()
+            version = int(parts[1]) if len(parts) > 1 and parts[1].isdigit() else 2
+        elif header is None:
+            continue
+        elif line.startswith("#op "):
+            _, num, name = line.split(" ", 2)
+            ops[int(num)] = name
+        elif line == "#END":
+            yield header, ops, records
+            header = None
+        else:
+            try:
+                raw = bytes.fromhex(line)
+            except ValueError:
+                continue  # interleaved log line
+            record = unpack(version, raw)
+            if record:
+                records.append(record)
+
+
+def status_name(code):
+    return STATUS[code] if code < len(STATUS) else str(code)
+
+
+def write_csv(blocks, out):
+    out.write("block,post_ms,resolved_ms,delta_ms,opcode,name,a,b,status,gap_ms,queue_depth\n")
+    for n, (_, ops, records) in enumerate(blocks):
+        for post, delta, gap, a, b, op, status, depth in records:
+            out.write("%d,%d,%d,%d,%d,%s,%d,%d,%s,%d,%d\n" % (
+                n, post, post + delta, delta, op, ops.get(op, "?"), a, b,
+                status_name(status), gap, depth))
+
+
+def write_timeline(blocks, out):
+    for header, ops, records in blocks:
+        out.write(header + "\n")
+        t0 = records[0][0] if records else 0
+        for post, delta, gap, a, b, op, status, depth in records:
+            out.write("  +%7d ms  %-10s a=%-5d b=%-5d %-10s after %5d ms  gap=%-4d depth=%d\n" % (
+                post + delta - t0, ops.get(op, "op%d" % op), a, b, status_name(status),
+                delta, gap, depth))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="serial capture file, or - for stdin")
+    parser.add_argument("--timeline", action="store_true", help="human-readable output instead of CSV")
+    args = parser.parse_args()
+
+    src = sys.stdin if args.input == "-" else open(args.input, errors="replace")
+    blocks = list(parse(src))
+    if args.timeline:
+        write_timeline(blocks, sys.stdout)
+    else:
+        write_csv(blocks, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
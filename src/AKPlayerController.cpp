@@ -54,24 +54,17 @@ void AKPlayerController::begin() {
   i2s.addAction(AudioDriverKey::KEY_VOLUME_UP, [](bool pressed, int /*pin*/, void* ctx){
     if (!pressed) return;
     auto* self = static_cast<AKPlayerController*>(ctx);
-    if (self->lastSetPlayerVolume < 30)
-      self->setPlayerVolume(self->lastSetPlayerVolume + 1);
+    self->setVolume(self->getVolume() + 1);  // clamped to MAX_VOLUME
   }, this);
 
   i2s.addAction(AudioDriverKey::KEY_VOLUME_DOWN, [](bool pressed, int /*pin*/, void* ctx){
     if (!pressed) return;
     auto* self = static_cast<AKPlayerController*>(ctx);
-    if (self->lastSetPlayerVolume > 0)
-      self->setPlayerVolume(self->lastSetPlayerVolume - 1);
+    self->setVolume(self->getVolume() - 1);  // clamped to MIN_VOLUME
   }, this);
 
-    // Set initial volume
-    // TODO review this code, the implementing sketch should be responsible for setting the volume
-    auto vcfg = volumeStream.defaultConfig();
-    vcfg.copyFrom(config);
-    // vcfg.allow_boost = true; // Uncomment to activate amplification using linear control
-    volumeStream.begin(vcfg);
-    // volumeStream.setVolume(0.7); // Initial volume at 70%
+    // Gain stage starts at unity; the implementing sketch sets the volume
+    gainStream.setAudioInfo(config);
 
     // SD_MMC is mounted by SdFileManager::mount() before player.begin() — do not remount here.
     if (SD_MMC.cardType() == CARD_NONE) {
@@ -90,6 +83,7 @@ void AKPlayerController::begin() {
     decoder.begin();
     // Propagate format changes downstream so I2S reconfigures before audio arrives
     decoder.addNotifyAudioChange(i2s);
+    decoder.addNotifyAudioChange(gainStream);  // sample rate for ramp lengths
 
     // Initialize the copier — route through MetaDataFilter so ID3 tags never reach HeliX
     copier.setCheckAvailableForWrite(false);
@@ -97,17 +91,18 @@ void AKPlayerController::begin() {
 
 }
 
-void AKPlayerController::enableLoop()  { isLooping = true;  executePlayerCommandBase(AKCmd_SetCycle, 1); }
-void AKPlayerController::disableLoop() { isLooping = false; executePlayerCommandBase(AKCmd_SetCycle, 0); }
+void AKPlayerController::enableLoop()  { PlayerLockGuard lock(_apiMutex); isLooping = true;  executePlayerCommandBase(AKCmd_SetCycle, 1); }
+void AKPlayerController::disableLoop() { PlayerLockGuard lock(_apiMutex); isLooping = false; executePlayerCommandBase(AKCmd_SetCycle, 0); }
 
 //void AKPlayerController::disableLoop() {
 //  isLooping = false;
 //}
 
 void AKPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+  PlayerLockGuard lock(_apiMutex);
   Serial.printf("  ▶️ %s - track: %u (Dec) '%s', duration: %lu ms\n", __PRETTY_FUNCTION__, track, trackName, durationMs);
 
-  executePlayerCommandNowBase(AKCmd_PlayTrack, (uint16_t)track);
+  const uint16_t ticket = submitPlayerCommandBase(AKCmd_PlayTrack, (uint16_t)track);
 
 //  // Close any previously opened file
 //  // TODO Only close the file if the new file is successfully opened
@@ -140,8 +135,8 @@ void AKPlayerController::playTrack(int track, unsigned long durationMs, const ch
 //  // Start the copier
 //  copier.begin(decoder, audioFile);
 
-  // Call the base class for housekeeping
-  PlayerController::playSoundSetStatus(track, durationMs, trackName);
+  // Call the base class for housekeeping (untouched if the play was not queued)
+  PlayerController::playSoundSetStatus(track, durationMs, trackName, ticket);
 }
 
 void AKPlayerController::playSound(int track, unsigned long durationMs, const char* trackName) {
@@ -150,18 +145,17 @@ void AKPlayerController::playSound(int track, unsigned long durationMs, const ch
 }
 
 void AKPlayerController::stop() {
-  if (audioFile) {
-    executePlayerCommandNowBase(AKCmd_Stop);
-    // audioFile.close();
-  }
+  PlayerLockGuard lock(_apiMutex);
+  // Always queue the stop: a play that is still queued has not opened its
+  // file yet, so audioFile alone cannot tell whether there is anything to stop.
+  if (submitPlayerCommandBase(AKCmd_Stop) == 0) return;  // not queued: still playing
 
   PlayerController::stopSoundSetStatus();
 }
 
 void AKPlayerController::setPlayerVolume(uint8_t v) {
   if (v > 30) v = 30;
-  if (lastSetPlayerVolume == v) return;
-  executePlayerCommandNowBase(AKCmd_Volume, v);
+  executePlayerCommandBase(AKCmd_Volume, v);  // skipped by the base if unchanged
 
 
 ////  Serial.println("setPlayerVolume not implemented YET...");
@@ -181,11 +175,46 @@ void AKPlayerController::setPlayerVolume(uint8_t v) {
 //  lastSetPlayerVolume = playerVolume;
 }
 
+// Fades run in the gain stage instead of as a string of volume commands. The
+// ramp is one queued command, so it stays in order with plain volume writes.
+bool AKPlayerController::beginHardwareFade(int targetVolume, uint32_t durationMs, FadeCurve curve) {
+  if (durationMs > 0xFFFF) return false;  // b is 16 bits; the base steps longer fades
+  const uint16_t a = (uint16_t)constrain(targetVolume, 0, 30) | ((uint16_t)curve << 8);
+  // Not queued: the base falls back to stepping the fade.
+  return executePlayerCommandBase(AKCmd_VolumeRamp, a, (uint16_t)durationMs);
+}
+
+bool AKPlayerController::armNextTrack(int track) {
+  if (_nextFile) _nextFile.close();
+  char path[32];
+  snprintf(path, sizeof(path), "/%05u.mp3", (unsigned)track);
+  _nextFile = SD_MMC.open(path);
+  if (debug) { Serial.print(F("[AK] next armed ")); Serial.print(path); Serial.println(_nextFile ? "" : " (open failed)"); }
+  return (bool)_nextFile;
+}
+
+void AKPlayerController::disarmNextTrack() {
+  if (_nextFile) _nextFile.close();
+  _nextFile = File();
+}
+
 void AKPlayerController::setEqualizerPreset(EqualizerPreset preset) {
+  PlayerLockGuard lock(_apiMutex);
   Serial.printf("EQ preset %d selected (not implemented for AK player)\n", static_cast<int>(preset));
 }
 
+const PlayerPeepholeRule* AKPlayerController::peepholeRules(uint8_t& count) const {
+  static const PlayerPeepholeRule rules[] = {
+    { AKCmd_Stop,     AKCmd_PlayTrack },  // PlayTrack closes the current file itself
+    { AKCmd_SetCycle, AKCmd_SetCycle  },  // only the newest loop mode matters
+    { AKCmd_VolumeRamp, AKCmd_Volume  },  // a volume write cancels the ramp anyway
+  };
+  count = sizeof(rules) / sizeof(rules[0]);
+  return rules;
+}
+
 void AKPlayerController::update() {
+  PlayerLockGuard lock(_apiMutex);
   //...
   // TODO enable via a method in the class...
   i2s.audioActions().processActions();  // poll & dispatch button actions
@@ -198,7 +227,18 @@ void AKPlayerController::update() {
           const bool inGrace = _trackJustStarted &&
                                ((millis() - _trackStartMs) < TRACK_START_GRACE_MS);
           if (!inGrace) {
-              if (isLooping) {
+              if (_nextFile) {
+                  // Queued next track: keep the decoder and I2S running and
+                  // feed it the next file (MP3 frames resync on their own).
+                  audioFile.close();
+                  audioFile = _nextFile;
+                  _nextFile = File();
+                  _filter.begin();  // strip the next file's ID3 tag too
+                  copier.begin(_filter, audioFile);
+                  _trackJustStarted = true;
+                  _trackStartMs     = millis();
+                  PlayerController::nextTrackChained();
+              } else if (isLooping) {
                   // If looping, seek back to the beginning and reset decoder
                   audioFile.seek(0);
                   decoder.begin();
@@ -207,15 +247,26 @@ void AKPlayerController::update() {
               } else {
                   // If not looping, close the file
                   audioFile.close();
-                  PlayerController::stopSoundSetStatus();
+                  PlayerController::stopSoundSetStatus(/*endOfTrack=*/true);
               }
           }
       } else {
           // Successful copy — decoder is synced, exit grace period
           _trackJustStarted = false;
+          if (_awaitingFirstAudio) {
+            _awaitingFirstAudio = false;
+            const uint32_t firstAudioMs = min(millis() - _trackStartMs, (uint32_t)1000);
+            noteWireToStatusLatency(AKCmd_PlayTrack, firstAudioMs);
+            // EWMA (1/4): follows the card, ignores a single slow open.
+            _firstAudioMs = _firstAudioMs ? (uint16_t)((3u * _firstAudioMs + firstAudioMs + 2) / 4) : (uint16_t)firstAudioMs;
+          }
       }
 
   }
+  if (_rampTarget >= 0 && !gainStream.isRamping()) {
+      noteShadowState(PlayerStateKey::Volume, (uint16_t)_rampTarget);  // the ramp arrived
+      _rampTarget = -1;
+  }
   PlayerController::update(); // Call the base class update method
 }
 
@@ -300,7 +351,7 @@ void AKPlayerController::printSDCardIndex(File dir, String path, int* fileCount,
   }
 }
 
-void AKPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t /*b*/) {
+void AKPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t b) {
   switch (type) {
     case AKCmd_PlayTrack: {
       // Close current
@@ -343,8 +394,9 @@ void AKPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t /*b*/) {
 
       // Start grace period — transient copy() failures while the HeliX decoder
       // resyncs to the new file's MP3 frames will not be treated as end-of-file.
-      _trackJustStarted = true;
-      _trackStartMs     = millis();
+      _trackJustStarted   = true;
+      _trackStartMs       = millis();
+      _awaitingFirstAudio = true;
 
       break;
     }
@@ -365,8 +417,22 @@ void AKPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t /*b*/) {
       float vol = (float)a / 30.0f;
       if (vol < 0.0f) vol = 0.0f; if (vol > 1.0f) vol = 1.0f;
       if (debug) { Serial.print(F("[WIRE:AK] volume(")); Serial.print(vol, 2); Serial.println(')'); }
-      volumeStream.setVolume(vol);
-      lastSetPlayerVolume = (int8_t)constrain((int)a, (int)MIN_VOLUME, (int)MAX_VOLUME);
+      gainStream.setGain(vol);
+      _rampTarget = -1;  // cancels a running ramp
+      break;
+    }
+
+    case AKCmd_VolumeRamp: {
+      const float vol = (float)min((uint16_t)(a & 0xFF), (uint16_t)30) / 30.0f;
+      const PlayerFadeCurve curve = (PlayerFadeCurve)(a >> 8);
+      if (debug) {
+        Serial.print(F("[WIRE:AK] ramp(")); Serial.print(gainStream.gain(), 2); Serial.print(F(" -> "));
+        Serial.print(vol, 2); Serial.print(F(", ")); Serial.print(b); Serial.println(F(" ms)"));
+      }
+      gainStream.rampTo(vol, b, curve);
+      // A volume write that matches the target mid-ramp must not be skipped.
+      forgetShadowState(PlayerStateKey::Volume);
+      _rampTarget = (int16_t)min((uint16_t)(a & 0xFF), (uint16_t)30);
       break;
     }
 
@@ -376,4 +442,74 @@ void AKPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t /*b*/) {
   }
 }
 
+// --- AKGainRampStream ---
+
+int32_t AKGainRampStream::toQ30_(float gain) {
+  if (gain <= 0.0f) return 0;
+  if (gain >= 1.0f) return GAIN_ONE;
+  return (int32_t)(gain * GAIN_ONE);
+}
+
+void AKGainRampStream::setGain(float gain) {
+  _gainQ30 = toQ30_(gain);
+  _stepQ30 = 0;
+  _segFramesLeft = 0;
+  _segment = SEGMENTS;
+}
+
+void AKGainRampStream::rampTo(float gain, uint32_t durationMs, PlayerFadeCurve curve) {
+  const uint32_t rate = audioInfo().sample_rate > 0 ? audioInfo().sample_rate : 44100;
+  _fromQ30 = _gainQ30;  // from wherever the audio is now, also mid-ramp
+  _toQ30 = toQ30_(gain);
+  _curve = curve;
+  _segFrames = (uint32_t)((uint64_t)durationMs * rate / 1000 / SEGMENTS);
+  _segment = 0;
+  if (_segFrames == 0) { setGain(gain); return; }
+  nextSegment_();
+}
+
+// Aims the per-frame step at the curve's next table point; the last segment
+// ends exactly on the target.
+void AKGainRampStream::nextSegment_() {
+  if (_segment >= SEGMENTS) {
+    _gainQ30 = _toQ30;
+    _stepQ30 = 0;
+    _segFramesLeft = 0;
+    return;
+  }
+  _segment++;
+  const int64_t span = (int64_t)_toQ30 - _fromQ30;
+  const int64_t end = _segment >= SEGMENTS ? _toQ30
+                    : _fromQ30 + span * playerFadeCurveQ8(_curve, _segment, SEGMENTS, span > 0) / 255;
+  _stepQ30 = (int32_t)((end - _gainQ30) / (int64_t)_segFrames);
+  _segFramesLeft = _segFrames;
+}
+
+size_t AKGainRampStream::write(const uint8_t* data, size_t len) {
+  const AudioInfo info = audioInfo();
+  if (info.bits_per_sample != 16) return _out.write(data, len);
+  const uint8_t channels = info.channels > 0 ? info.channels : 2;
+
+  int16_t buf[128];
+  size_t done = 0;
+  while (len - done >= sizeof(int16_t)) {
+    const size_t n = min((len - done) / sizeof(int16_t), sizeof(buf) / sizeof(buf[0]));
+    memcpy(buf, data + done, n * sizeof(int16_t));
+    for (size_t i = 0; i < n; i++) {
+      buf[i] = (int16_t)(((int32_t)buf[i] * (_gainQ30 >> 14)) >> 16);  // Q16 gain, max 1.0
+      if (++_channel >= channels) {
+        _channel = 0;
+        if (_segFramesLeft > 0) {
+          _gainQ30 += _stepQ30;
+          if (--_segFramesLeft == 0) nextSegment_();
+        }
+      }
+    }
+    _out.write((const uint8_t*)buf, n * sizeof(int16_t));
+    done += n * sizeof(int16_t);
+  }
+  if (done < len) _out.write(data + done, len - done);  // stray odd byte
+  return len;
+}
+
 #endif // Not on ESP32
@@ -16,10 +16,47 @@
 
 #include "BauklankPlayerController.h"
 
+// Gain stage between the MP3 decoder and the I2S output. A volume command sets
+// the gain at once; rampTo() moves it sample by sample, piecewise linear over
+// the fade curve's table intervals, so AK fades have no zipper steps whatever
+// their length. Expects 16-bit PCM (what HeliX produces); other formats pass
+// through untouched.
+class AKGainRampStream : public AudioStream {
+public:
+  explicit AKGainRampStream(Print& out) : _out(out) {}
+
+  void  setGain(float gain);  // immediate, cancels a running ramp
+  void  rampTo(float gain, uint32_t durationMs, PlayerFadeCurve curve);
+  float gain() const { return (float)_gainQ30 / GAIN_ONE; }
+  bool  isRamping() const { return _segFramesLeft > 0; }
+
+  size_t write(const uint8_t* data, size_t len) override;
+  int availableForWrite() override { return _out.availableForWrite(); }
+
+private:
+  static constexpr int32_t GAIN_ONE = 1L << 30;  // Q30
+  static const uint8_t SEGMENTS = 32;            // one per curve table interval
+
+  static int32_t toQ30_(float gain);
+  void nextSegment_();
+
+  Print&   _out;
+  int32_t  _gainQ30 = GAIN_ONE;
+  int32_t  _stepQ30 = 0;         // per frame, within the current segment
+  int32_t  _fromQ30 = 0;
+  int32_t  _toQ30   = 0;
+  uint32_t _segFrames = 0;
+  uint32_t _segFramesLeft = 0;   // 0 = not ramping
+  uint8_t  _segment = SEGMENTS;
+  uint8_t  _channel = 0;         // sample position within the frame, kept across writes
+  PlayerFadeCurve _curve = PlayerFadeCurve::LINEAR;
+};
+
 class AKPlayerController : public PlayerController {
 public:
   const char* getPlayerTypeName() const override { return "AK Player"; }
   AKPlayerController();
+  ~AKPlayerController() override { stopServiceTask(); }
   //  AKPlayerController(int rxPin, int txPin);
   void begin() override;
   void playSound(int track, unsigned long durationMs, const char* trackName) override;
@@ -29,6 +66,8 @@ public:
   void disableLoop() override;
   void setEqualizerPreset(EqualizerPreset preset) override;
   void update();
+  // The copier sees end-of-file, so tracks without a duration end too.
+  bool reportsEndOfTrack() const override { return true; }
 
   // Print audio file info
   void printAudioFileInfo(const char* path);
@@ -43,13 +82,46 @@ protected:
     AKCmd_PlayTrack,   // a = track number (/%05d.mp3)
     AKCmd_Stop,
     AKCmd_SetCycle,    // a = 0 OneOff, 1 RepeatOne
-    AKCmd_Volume       // a = 0..30
+    AKCmd_Volume,      // a = 0..30
+    AKCmd_VolumeRamp   // a = target 0..30 | curve << 8, b = duration ms
   };
 
+  bool beginHardwareFade(int targetVolume, uint32_t durationMs, FadeCurve curve) override;
+  // Gapless queueNextTrack(): the next file is opened ahead and handed to the
+  // copier at end-of-file, with the decoder and I2S left running.
+  bool armNextTrack(int track) override;
+  void disarmNextTrack() override;
+
   // AK is local + fast; small, even gaps are fine 30-60ms
   uint16_t normalGapMs()    const override { return 30; }
   uint16_t afterPlayGapMs() const override { return 60; }
+  // Measured on every play (file open + first decoded frame), ~50 ms from SD_MMC.
+  uint16_t playStartLatencyMs() const override { return _firstAudioMs ? _firstAudioMs : 50; }
   bool isPlayCommand(uint8_t t) const override { return t == AKCmd_PlayTrack; }
+  // A newer ramp retargets a queued one (it starts from wherever the gain is).
+  bool isCoalescableCommand(uint8_t t) const override { return t == AKCmd_Volume || t == AKCmd_VolumeRamp; }
+  const PlayerPeepholeRule* peepholeRules(uint8_t& count) const override;
+  PlayerCommandClass commandClass(uint8_t t) const override {
+    switch (t) {
+      case AKCmd_Stop:      return PlayerCommandClass::Urgent;
+      case AKCmd_PlayTrack: return PlayerCommandClass::Play;
+      case AKCmd_Volume:
+      case AKCmd_VolumeRamp: return PlayerCommandClass::Bulk;
+      default:              return PlayerCommandClass::Control;
+    }
+  }
+
+  bool commandStateEffect(uint8_t t, uint16_t a, uint16_t b,
+                          PlayerStateKey& key, uint16_t& value) const override {
+    switch (t) {
+      case AKCmd_SetCycle: key = PlayerStateKey::Loop;   value = a ? 1 : 0; return true;
+      case AKCmd_Volume:   key = PlayerStateKey::Volume; value = a;         return true;
+      // Where it ends. Counts as a pending volume while queued; once sent the
+      // shadow stays unknown until the ramp gets there (update()).
+      case AKCmd_VolumeRamp: key = PlayerStateKey::Volume; value = a & 0xFF; return true;
+      default:             return false;
+    }
+  }
 
   const char* cmdName(uint8_t t) const override {
     switch (t) {
@@ -57,6 +129,7 @@ protected:
       case AKCmd_Stop:      return "Stop";
       case AKCmd_SetCycle:  return "SetCycle";
       case AKCmd_Volume:    return "Volume";
+      case AKCmd_VolumeRamp: return "VolumeRamp";
       default:              return "AK?";
     }
   }
@@ -64,7 +137,6 @@ protected:
 private:
   void sendCommand(uint8_t type, uint16_t a, uint16_t b) override;
 
-  int8_t lastSetPlayerVolume = -1;  // Initialize to an invalid value
   uint8_t currentVolume; // To keep track of the current volume
   bool isLooping = false;
 
@@ -74,6 +146,10 @@ private:
   static constexpr uint32_t TRACK_START_GRACE_MS = 500;
   bool     _trackJustStarted = false;
   uint32_t _trackStartMs     = 0;
+  bool     _awaitingFirstAudio = false;  // PlayTrack written, no audio decoded yet
+  uint16_t _firstAudioMs = 0;            // running average of PlayTrack -> first audio, 0 = none yet
+  File     _nextFile;                    // armed by queueNextTrack(), swapped in at end-of-file
+  int16_t  _rampTarget = -1;             // volume a running VolumeRamp ends at, -1 = none
 
   // Optional remount callback — called when SD_MMC.open() fails.
   // Should remount the SD card and return true on success.
@@ -89,11 +165,11 @@ private:
   // Create an AudioBoardStream object for the final output
   AudioBoardStream i2s = AudioBoardStream(AudioKitEs8388V1); // final output of decoded stream
 
-  // Create a Volume stream for manipulating the volume
-  VolumeStream volumeStream = VolumeStream(i2s);
+  // Gain stage for volume and sample-accurate fades
+  AKGainRampStream gainStream = AKGainRampStream(i2s);
 
   // Create an EncodedAudioStream object for MP3 decoding
-  EncodedAudioStream decoder = EncodedAudioStream(&volumeStream, new MP3DecoderHelix()); // Decoding stream
+  EncodedAudioStream decoder = EncodedAudioStream(&gainStream, new MP3DecoderHelix()); // Decoding stream
   MetaDataFilter _filter = MetaDataFilter(decoder); // Strips ID3/metadata before decoding
 
   // Create a StreamCopy object for copying data between streams
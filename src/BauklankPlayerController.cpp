@@ -94,6 +94,7 @@ void PlayerController::begin() {
  * @see MAX_VOLUME
  */
 void PlayerController::setVolume(int _volume) {
+    PlayerLockGuard lock(_apiMutex);
     DEBUG_PRINT(DebugLevel::VOLUME, "🔊 Setting volume to %d", _volume);
 
     currentVolume = constrain(_volume, MIN_VOLUME, MAX_VOLUME);
@@ -152,11 +153,30 @@ void PlayerController::decodeFolderAndTrack(uint16_t trackNumber, uint8_t& folde
 }
 
 void PlayerController::playSoundSetStatus(int track, unsigned long durationMs, const char* trackName) {
+  PlayerLockGuard lock(_apiMutex);
+  setPlayStatus_(track, durationMs, trackName, 0);
+}
 
+void PlayerController::playSoundSetStatus(int track, unsigned long durationMs, const char* trackName, uint16_t playTicket) {
+  PlayerLockGuard lock(_apiMutex);
+  if (playTicket == 0) {
+      DEBUG_PRINT(DebugLevel::COMMANDS, "⚠️ %s - play of track %d was not queued, status unchanged", __PRETTY_FUNCTION__, track);
+      return;
+  }
+  setPlayStatus_(track, durationMs, trackName, playTicket);
+}
+
+void PlayerController::setPlayStatus_(int track, unsigned long durationMs, const char* trackName, uint16_t playTicket) {
   //  DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::PLAYBACK, "  ▶️ %s - track: %u (Dec) '%s', duration: %lu ms", __PRETTY_FUNCTION__, track, trackName, durationMs);
 
   playerStatus = STATUS_PLAYING;
   currentTrack = track;
+  _playTicket = playTicket;
+  // An ON_PLAY envelope starts with this track, once its play frame has gone
+  // out.
+  if (_envelope && _envelopeArmed) {
+      startEnvelopeNow_(isCommandPending(playTicket) ? playTicket : 0);
+  }
   // Add duration
   if (durationMs > 0) {
       playStartTime = millis();
@@ -181,38 +201,305 @@ void PlayerController::playSoundSetStatus(int track, unsigned long durationMs, c
   displayPlayerStatusBox();
 }
 
-void PlayerController::schedulePlay(int track, unsigned long durationMs,
-                                   const char* trackName, int volume,
-                                   uint32_t countdownMs) {
-    // last-wins, mirror the syncTrigger arming order (clear -> set)
-    _syncPlayPending  = false;
-    _syncPlayTrack    = track;
-    _syncPlayDuration = durationMs;
-    _syncPlayName     = trackName;   // static/flash pointer (see header note)
-    _syncPlayVolume   = volume;
-    _syncPlayFireAtMs = millis() + countdownMs;
-    _syncPlayPending  = true;
-    DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️ %s - schedulePlay track=%d in %lu ms", __PRETTY_FUNCTION__, track, (unsigned long)countdownMs);
+PlayerController::ScheduleHandle PlayerController::scheduleAction_(const ScheduledAction& action, uint32_t countdownMs) {
+    PlayerLockGuard lock(_apiMutex);
+    const ScheduleHandle handle = _timeline.push(millis() + countdownMs, action);
+    if (handle == 0) {
+        DEBUG_PRINT(DebugLevel::COMMANDS, "⚠️ %s - timeline full (%u), action %u dropped", __PRETTY_FUNCTION__,
+                    (unsigned)_timeline.capacity(), (unsigned)action.type);
+    }
+    return handle;
+}
+
+PlayerController::ScheduleHandle PlayerController::schedulePlay(int track, unsigned long durationMs,
+                                                                const char* trackName, int volume,
+                                                                uint32_t countdownMs, bool preRoll) {
+    ScheduledAction action;
+    action.type       = ScheduledActionType::Play;
+    action.track      = track;
+    action.durationMs = durationMs;
+    action.trackName  = trackName;   // static/flash pointer (see header note)
+    action.volume     = (int8_t)(volume < 0 ? -1 : constrain(volume, MIN_VOLUME, MAX_VOLUME));
+    if (preRoll && getPreRollMs() > 0) {
+        // Start muted early; the Unmute lands on the scheduled time.
+        action.type      = ScheduledActionType::PreRollPlay;
+        action.preRollMs = (uint16_t)min((uint32_t)getPreRollMs(), countdownMs);
+        DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️ %s - schedulePlay track=%d in %lu ms (muted from %u ms early)", __PRETTY_FUNCTION__,
+                    track, (unsigned long)countdownMs, action.preRollMs);
+        return scheduleAction_(action, countdownMs - action.preRollMs);
+    }
+    // Fire early by the module's start-up time (as far as the countdown allows).
+    const uint32_t leadMs = _playStartCompensation ? min((uint32_t)getPlayStartLatencyMs(), countdownMs) : 0;
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️ %s - schedulePlay track=%d in %lu ms (fires %lu ms early)", __PRETTY_FUNCTION__, track,
+                (unsigned long)countdownMs, (unsigned long)leadMs);
+    return scheduleAction_(action, countdownMs - leadMs);
+}
+
+PlayerController::ScheduleHandle PlayerController::scheduleStop(uint32_t countdownMs) {
+    ScheduledAction action;
+    action.type = ScheduledActionType::Stop;
+    return scheduleAction_(action, countdownMs);
+}
+
+PlayerController::ScheduleHandle PlayerController::scheduleFadeTo(int durationMs, int targetVolume, uint32_t countdownMs, FadeCurve curve) {
+    ScheduledAction action;
+    action.type       = ScheduledActionType::FadeTo;
+    action.volume     = (int8_t)constrain(targetVolume, MIN_VOLUME, MAX_VOLUME);
+    action.durationMs = (unsigned long)max(durationMs, 0);
+    action.arg        = (uint8_t)curve;
+    return scheduleAction_(action, countdownMs);
+}
+
+PlayerController::ScheduleHandle PlayerController::scheduleVolume(int volume, uint32_t countdownMs) {
+    ScheduledAction action;
+    action.type   = ScheduledActionType::SetVolume;
+    action.volume = (int8_t)constrain(volume, MIN_VOLUME, MAX_VOLUME);
+    return scheduleAction_(action, countdownMs);
+}
+
+PlayerController::ScheduleHandle PlayerController::scheduleEqualizerPreset(EqualizerPreset preset, uint32_t countdownMs) {
+    ScheduledAction action;
+    action.type = ScheduledActionType::SetEqualizerPreset;
+    action.arg  = (uint8_t)preset;
+    return scheduleAction_(action, countdownMs);
+}
+
+bool PlayerController::cancelScheduled(ScheduleHandle handle) {
+    PlayerLockGuard lock(_apiMutex);
+    return _timeline.cancel(handle);
 }
 
 void PlayerController::cancelScheduledPlay() {
-    _syncPlayPending = false;
+    PlayerLockGuard lock(_apiMutex);
+    // Rare (stop), so a scan is fine; restart after each removal because it
+    // reorders the heap.
+    for (uint8_t i = 0; i < _timeline.size(); ) {
+        if (isScheduledPlay_(_timeline.payloadAt(i).type)) {
+            if (_timeline.payloadAt(i).type == ScheduledActionType::Unmute) setVolume(_timeline.payloadAt(i).volume);
+            _timeline.cancel(_timeline.handleAt(i));
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+}
+
+void PlayerController::clearSchedule() {
+    PlayerLockGuard lock(_apiMutex);
+    restorePreRollVolume_();
+    _timeline.clear();
+}
+
+// A pre-rolled play cut short must not leave the module muted.
+void PlayerController::restorePreRollVolume_() {
+    for (uint8_t i = 0; i < _timeline.size(); i++) {
+        if (_timeline.payloadAt(i).type == ScheduledActionType::Unmute) setVolume(_timeline.payloadAt(i).volume);
+    }
+}
+
+bool PlayerController::hasScheduledPlay() const {
+    for (uint8_t i = 0; i < _timeline.size(); i++) {
+        if (isScheduledPlay_(_timeline.payloadAt(i).type)) return true;
+    }
+    return false;
+}
+
+// Runs a due timeline entry through the public API, as if the sketch had
+// called it at that moment. fireAtMs is when it was due (update() may be late).
+void PlayerController::fireScheduled_(const ScheduledAction& action, uint32_t fireAtMs) {
+    _firingScheduled = true;
+    switch (action.type) {
+        case ScheduledActionType::Play:
+            if (isFading()) stopFade(/*stopSound=*/false);  // match live playSound path
+            if (action.volume >= 0) setVolume(action.volume);
+            playTrack(action.track, action.durationMs, action.trackName);
+            DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️▶️ %s - syncPlaySound fired track=%d", __PRETTY_FUNCTION__, action.track);
+            break;
+        case ScheduledActionType::PreRollPlay: {
+            if (isFading()) stopFade(/*stopSound=*/false);
+            ScheduledAction unmute;
+            unmute.type   = ScheduledActionType::Unmute;
+            unmute.volume = (int8_t)(action.volume >= 0 ? action.volume : currentVolume);
+            // The volume queued first goes out first (a play is an ordering
+            // barrier). An ON_PLAY envelope waits for the unmute.
+            const bool envelopeArmed = _envelopeArmed;
+            _envelopeArmed = false;
+            setVolume(MIN_VOLUME);
+            playTrack(action.track, action.durationMs ? action.durationMs + action.preRollMs : 0, action.trackName);
+            _envelopeArmed = envelopeArmed;
+            // Timed from the due time, so a late update() does not also delay
+            // the unmute.
+            if (_timeline.push(fireAtMs + action.preRollMs, unmute) == 0) setVolume(unmute.volume);  // full: unmute now
+            DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️▶️ %s - pre-roll track=%d muted, volume %d in %u ms", __PRETTY_FUNCTION__,
+                        action.track, unmute.volume, action.preRollMs);
+            break;
+        }
+        case ScheduledActionType::Unmute:
+            if (isFading()) stopFade(/*stopSound=*/false);
+            if (_envelope && _envelopeArmed) {
+                _envelopeArmed = false;
+                startEnvelopeNow_(0);
+            } else {
+                setVolume(action.volume);
+            }
+            break;
+        case ScheduledActionType::Stop:
+            stop();
+            break;
+        case ScheduledActionType::FadeTo:
+            fadeTo((int)action.durationMs, action.volume, (FadeCurve)action.arg);
+            break;
+        case ScheduledActionType::SetVolume:
+            if (isFading()) stopFade(/*stopSound=*/false);
+            setVolume(action.volume);
+            break;
+        case ScheduledActionType::SetEqualizerPreset:
+            setEqualizerPreset((EqualizerPreset)action.arg);
+            break;
+    }
+    _firingScheduled = false;
 }
 
-void PlayerController::stopSoundSetStatus() {
+void PlayerController::playSoundRandom(int minTrack, int maxTrack, unsigned long durationMs, const char* trackName) {
+    PlayerLockGuard lock(_apiMutex);
+    if (maxTrack < minTrack) return;
+    const int span = maxTrack - minTrack + 1;
+    int track = minTrack + (int)random(span);
+    // No immediate repeat: shift by 1..span-1 instead of drawing again.
+    if (track == _lastRandomTrack && span > 1) track = minTrack + (track - minTrack + 1 + (int)random(span - 1)) % span;
+    _lastRandomTrack = track;
+    DEBUG_PRINT(DebugLevel::COMMANDS, "🎲 %s - track %d from %d..%d", __PRETTY_FUNCTION__, track, minTrack, maxTrack);
+    playTrack(track, durationMs, trackName);
+}
+
+bool PlayerController::queueNextTrack(int track, unsigned long durationMs, const char* trackName, int leadMs) {
+    PlayerLockGuard lock(_apiMutex);
+    if (!isSoundPlaying()) {
+        playTrack(track, durationMs, trackName);
+        return true;
+    }
+    clearQueuedNextTrack();
+    const bool chained = armNextTrack(track);
+    if (!chained && playDuration == 0 && !reportsEndOfTrack()) {
+        DEBUG_PRINT(DebugLevel::COMMANDS, "⚠️ %s - next track=%d refused: the current track has no duration and %s does not report its end",
+                    __PRETTY_FUNCTION__, track, getPlayerTypeName());
+        return false;
+    }
+    _next.queued     = true;
+    _next.track      = track;
+    _next.durationMs = durationMs;
+    _next.trackName  = trackName;
+    _next.leadMs     = (uint16_t)(leadMs < 0 ? getPlayStartLatencyMs() : min(leadMs, 0xFFFF));
+    _next.chained    = chained;
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⏭️ %s - next track=%d queued (%s)", __PRETTY_FUNCTION__, track,
+                _next.chained ? "chained by the backend" : "play at end");
+    return true;
+}
+
+void PlayerController::clearQueuedNextTrack() {
+    PlayerLockGuard lock(_apiMutex);
+    if (_next.chained) disarmNextTrack();
+    _next = NextTrack();
+}
+
+// Take the slot first: playTrack() may end up back in stopSoundSetStatus().
+void PlayerController::playQueuedNextTrack_() {
+    const NextTrack next = _next;
+    _next = NextTrack();
+    if (next.chained) disarmNextTrack();
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⏭️ %s - next track=%d", __PRETTY_FUNCTION__, next.track);
+    playTrack(next.track, next.durationMs, next.trackName);
+}
+
+// The backend switched files on its own: only the status follows.
+void PlayerController::nextTrackChained() {
+    PlayerLockGuard lock(_apiMutex);
+    if (!_next.queued) return;
+    const NextTrack next = _next;
+    _next = NextTrack();
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⏭️ %s - chained track=%d", __PRETTY_FUNCTION__, next.track);
+    playSoundSetStatus(next.track, next.durationMs, next.trackName);
+}
+
+void PlayerController::startEnvelope(const PlayerEnvelope& envelope, EnvelopeStart when) {
+    PlayerLockGuard lock(_apiMutex);
+    if (isFading()) stopFade(/*stopSound=*/false);
+    _envelope = &envelope;
+    _envelopeArmed = when == EnvelopeStart::ON_PLAY;
+    if (!_envelopeArmed) startEnvelopeNow_(0);
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📊 %s - %u points, %lu ms%s, %s", __PRETTY_FUNCTION__,
+                envelope.count(), (unsigned long)envelope.durationMs(), envelope.loops() ? " (loop)" : "",
+                _envelopeArmed ? "armed for next play" : "started");
+}
+
+void PlayerController::stopEnvelope() {
+    PlayerLockGuard lock(_apiMutex);
+    _envelope = nullptr;
+    _envelopeArmed = false;
+    _envelopeStartTicket = 0;
+}
+
+void PlayerController::startEnvelopeNow_(uint16_t waitForTicket) {
+    _envelopeArmed = false;
+    _envelopeStartTicket = waitForTicket;
+    _envelopeStartMs = millis();
+    _envelopeLastSendMs = _envelopeStartMs - normalGapMs();
+    _envelopeStartVolume = currentVolume;
+    _envelopeCursor = 0;
+}
+
+// Sends the envelope's volume when it changes, at most one step per command
+// gap (skipped values are never queued); the final breakpoint always goes out.
+void PlayerController::updateEnvelope_(uint32_t now) {
+    if (!_envelope || _envelopeArmed) return;
+    if (_envelopeStartTicket != 0) {
+        if (isCommandPending(_envelopeStartTicket)) return;
+        _envelopeStartTicket = 0;
+        startEnvelopeNow_(0);
+    }
+    const uint32_t elapsed = now - _envelopeStartMs;
+    const bool done = !_envelope->loops() && elapsed >= _envelope->durationMs();
+    const int volume = constrain(_envelope->volumeAt(elapsed, _envelopeStartVolume, _envelopeCursor), MIN_VOLUME, MAX_VOLUME);
+
+    if (volume != currentVolume && (done || now - _envelopeLastSendMs >= normalGapMs())) {
+        DEBUG_PRINT_AND(DebugLevel::REALTIME | DebugLevel::FADE, "📊🔊 - ENVELOPE - %lu ms: volume %d -> %d", (unsigned long)elapsed, currentVolume, volume);
+        _postValidForMs = normalGapMs();
+        setVolume(volume);
+        _postValidForMs = 0;
+        _envelopeLastSendMs = now;
+    }
+    if (done) {
+        _envelope = nullptr;
+        DEBUG_PRINT(DebugLevel::FADE, "📊✅ ENVELOPE - complete, final volume %d", currentVolume);
+    }
+}
+
+void PlayerController::stopSoundSetStatus(bool endOfTrack) {
+    PlayerLockGuard lock(_apiMutex);
     // TODO create a private method to reset the track when it is stopped
-    _syncPlayPending = false; // cancel any pending scheduled play on stop
+    if (!endOfTrack) {
+        // A stop fired by the timeline keeps the rest of the timeline, but
+        // any stop drops the gapless track queued behind this one.
+        if (!_firingScheduled) cancelScheduledPlay();
+        clearQueuedNextTrack();
+    }
+    if (_envelope && !_envelopeArmed) _envelope = nullptr;  // the envelope followed this sound
     playerStatus = STATUS_STOPPED;
     currentTrack = 0;
+    _playTicket = 0;
     currentTrackName = "";
     playDuration = 0; // Reset playDuration
 
     DEBUG_PRINT(DebugLevel::PLAYBACK | DebugLevel::COMMANDS, "⏹️ %s - PlayerStatus: %d", __PRETTY_FUNCTION__, playerStatus);
 
     displayPlayerStatusBox();
+
+    // Ended by itself (or the backend could not chain): the queued track follows.
+    if (endOfTrack && _next.queued) playQueuedNextTrack_();
 }
 
 void PlayerController::setEqualizerPreset(EqualizerPreset preset) {
+    PlayerLockGuard lock(_apiMutex);
     // Default implementation
     DEBUG_PRINT(DebugLevel::COMMANDS, "🎚️ %s - Setting equalizer preset: ", __PRETTY_FUNCTION__);
     currentEqualizerPreset = preset;
@@ -244,7 +531,9 @@ void PlayerController::setEqualizerPreset(EqualizerPreset preset) {
     }
 }
 
-void PlayerController::fadeIn(int durationMs, int targetVolume, int playTrackIndex, unsigned long trackDurationMs, const char* trackName) {
+void PlayerController::fadeIn(int durationMs, int targetVolume, int playTrackIndex, unsigned long trackDurationMs, const char* trackName,
+                              FadeCurve curve) {
+    PlayerLockGuard lock(_apiMutex);
     // Ensure duration is not less than the minimum
     durationMs = max(durationMs, MIN_FADE_DURATION_MS);
 
@@ -262,45 +551,48 @@ void PlayerController::fadeIn(int durationMs, int targetVolume, int playTrackInd
 
     // Start playing the track with the specified duration and name
     // Call the virtual function to play the track
+    _playTicket = 0;
     playTrack(playTrackIndex, trackDurationMs, trackName);
+    const uint16_t playTicket = _playTicket;
 //    Serial.printf("  !-> After playing the track\n");
-    // Non-yielding "give the sound time to start" gap. Must not call
-    // delay()/yield(): fadeIn() can run from the ESP-NOW receive callback
-    // (SYS context on ESP8266), where esp_yield() is illegal and reboots.
-    { uint32_t startGap = millis() + 60; while ((int32_t)(millis() - startGap) < 0) { /* spin, no yield */ } }
-//    Serial.printf("  !-> After the delay sound should have started\n");
 
-     DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - FadeDirection: %d", __PRETTY_FUNCTION__, fadeDirection);
+     DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - FadeDirection: %d", __PRETTY_FUNCTION__, (int)fadeDirection);
 //     Serial.printf("%s - FadeDirection: %d\n", __PRETTY_FUNCTION__, fadeDirection);
 
-    // Now set up the fade in
-    if (fadeDirection == FadeDirection::NONE) {
-        fadeStartTime = millis();
-        fadeDirection = FadeDirection::IN;
-
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - FadeDirection: %d", __PRETTY_FUNCTION__, fadeDirection);
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, this->targetVolume);
-//        Serial.printf("%s - FadeDirection: %d\n", __PRETTY_FUNCTION__, fadeDirection);
-//        Serial.printf("%s - Current volume: %d, Target volume: %d\n", __PRETTY_FUNCTION__, currentVolume, this->targetVolume);
-
-        this->targetVolume = constrain(targetVolume, MIN_VOLUME, MAX_VOLUME);
+    // Now set up the fade in. A fade already running is retargeted: the new
+    // track starts muted, so the ramp restarts from 0.
+    if (fadeDirection != FadeDirection::NONE) noteFadeRetarget_(__PRETTY_FUNCTION__);
+    fadeDirection = FadeDirection::IN;
+    shouldStopAfterFade = false;
 
-        int volumeDifference = this->targetVolume - currentVolume;
-        fadeIntervalMs = constrain(durationMs / volumeDifference, 10, 500); // Interval between 10ms and 500ms
-        volumeStep = 1;
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - FadeDirection: %d", __PRETTY_FUNCTION__, (int)fadeDirection);
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "%s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, this->targetVolume);
+//    Serial.printf("%s - FadeDirection: %d\n", __PRETTY_FUNCTION__, fadeDirection);
+//    Serial.printf("%s - Current volume: %d, Target volume: %d\n", __PRETTY_FUNCTION__, currentVolume, this->targetVolume);
 
-        lastFadeTime = millis();
+    this->targetVolume = constrain(targetVolume, MIN_VOLUME, MAX_VOLUME);
 
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📈🔢 %s - Fade calculation: Volume step: %d, Fade interval: %d ms", __PRETTY_FUNCTION__, volumeStep, fadeIntervalMs);
+    // Stop, mute and play go out in that order through the command queue.
+    // The ramp starts from update() once the play frame is on the wire, so
+    // this returns immediately (it may run from the ESP-NOW receive
+    // callback, where neither blocking nor yielding is allowed).
+    if (isCommandPending(playTicket)) {
+        _fadeInPlayTicket = playTicket;
+        _envelope = nullptr;
+        fadeDurationMs = (unsigned long)durationMs;
+        fadeCurve = curve;
 
+        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📈⏳ %s - Fade in armed, waiting for play ticket %u", __PRETTY_FUNCTION__, playTicket);
     } else {
+        _fadeInPlayTicket = 0;
+        beginFade_(fadeDirection, durationMs, curve);
 
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📈 %s - Fade already in progress, ignoring new fade request", __PRETTY_FUNCTION__);
-
+        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📈🔢 %s - Fade calculation: %u steps, step interval: %d ms", __PRETTY_FUNCTION__, (unsigned)fadeSteps, fadeIntervalMs);
     }
 }
 
-void PlayerController::fadeOut(int durationMs, int targetVolume = 0, bool stopSound = true) {
+void PlayerController::fadeOut(int durationMs, int targetVolume, bool stopSound, FadeCurve curve) {
+    PlayerLockGuard lock(_apiMutex);
     // Ensure duration is not less than the minimum
     durationMs = max(durationMs, MIN_FADE_DURATION_MS);
     shouldStopAfterFade = stopSound;
@@ -308,38 +600,34 @@ void PlayerController::fadeOut(int durationMs, int targetVolume = 0, bool stopSo
     DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📉 %s - should stop after fade: %s", __PRETTY_FUNCTION__, shouldStopAfterFade ? "true" : "false");
     DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📉 %s - Fade out requested: duration %d ms, target volume %d", __PRETTY_FUNCTION__, durationMs, targetVolume);
 
-    if (fadeDirection == FadeDirection::NONE) {
-        fadeStartTime = millis();
-        fadeDirection = FadeDirection::OUT;
-        currentVolume = constrain(getVolume(), MIN_VOLUME, MAX_VOLUME);
-        this->targetVolume = constrain(targetVolume, MIN_VOLUME, MAX_VOLUME);
-
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🔉 %s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, targetVolume);
-        //        Serial.printf("  🔉 %s - Current volume: %d, Target volume: %d\n", __PRETTY_FUNCTION__, currentVolume, targetVolume);
-
-        if (currentVolume <= targetVolume) {
-          fadeDirection = FadeDirection::NONE;
+    const bool wasFading = fadeDirection != FadeDirection::NONE;
+    currentVolume = constrain(getVolume(), MIN_VOLUME, MAX_VOLUME);
+    this->targetVolume = constrain(targetVolume, MIN_VOLUME, MAX_VOLUME);
 
-          DEBUG_PRINT(DebugLevel::COMMANDS, "📉🚫 %s - No need to fade out, current volume (%d) is already at or below target (%d)", __PRETTY_FUNCTION__, currentVolume, targetVolume);
-          return;
-        }
-
-        int volumeDifference = currentVolume - targetVolume;
-        fadeIntervalMs = constrain(durationMs / volumeDifference, 10, 500); // Interval between 10ms and 500ms
-        volumeStep = 1;
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🔉 %s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, targetVolume);
+    //        Serial.printf("  🔉 %s - Current volume: %d, Target volume: %d\n", __PRETTY_FUNCTION__, currentVolume, targetVolume);
 
-        lastFadeTime = millis();
+    if (wasFading) {
+        // Retarget the running fade towards the new target, in whichever
+        // direction that now is.
+        noteFadeRetarget_(__PRETTY_FUNCTION__);
+        retargetFade_(durationMs, curve);
+        return;
+    }
 
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📉🔢 %s - Fade calculation: Volume step: %d, Fade interval: %d ms", __PRETTY_FUNCTION__, volumeStep, fadeIntervalMs);
+    if (currentVolume <= this->targetVolume) {
 
-    } else {
+      DEBUG_PRINT(DebugLevel::COMMANDS, "📉🚫 %s - No need to fade out, current volume (%d) is already at or below target (%d)", __PRETTY_FUNCTION__, currentVolume, targetVolume);
+      return;
+    }
 
-      DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📉 %s - Fade already in progress, ignoring new fade request", __PRETTY_FUNCTION__);
+    beginFade_(FadeDirection::OUT, durationMs, curve);
 
-    }
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "📉🔢 %s - Fade calculation: %u steps, step interval: %d ms", __PRETTY_FUNCTION__, (unsigned)fadeSteps, fadeIntervalMs);
 }
 
-void PlayerController::fadeTo(int durationMs, int targetVolume) {
+void PlayerController::fadeTo(int durationMs, int targetVolume, FadeCurve curve) {
+    PlayerLockGuard lock(_apiMutex);
     // Do not stop sound when doing fadeTo 0
     shouldStopAfterFade = false;
 
@@ -351,35 +639,20 @@ void PlayerController::fadeTo(int durationMs, int targetVolume) {
 
     DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🎚️ %s - Fade to volume requested: duration %d ms, target volume %d", __PRETTY_FUNCTION__, durationMs, targetVolume);
 
-    if (fadeDirection == FadeDirection::NONE) {
-        fadeStartTime = millis();
-        currentVolume = constrain(getVolume(), MIN_VOLUME, MAX_VOLUME);
-        this->targetVolume = targetVolume;
+    const bool wasFading = fadeDirection != FadeDirection::NONE;
+    currentVolume = constrain(getVolume(), MIN_VOLUME, MAX_VOLUME);
+    this->targetVolume = targetVolume;
 
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🔉 %s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, targetVolume);
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🔉 %s - Current volume: %d, Target volume: %d", __PRETTY_FUNCTION__, currentVolume, targetVolume);
 
-        if (currentVolume < targetVolume) {
-            fadeDirection = FadeDirection::IN;
-        } else if (currentVolume > targetVolume) {
-            fadeDirection = FadeDirection::OUT;
-        } else {
+    if (wasFading) noteFadeRetarget_(__PRETTY_FUNCTION__);
+    if (!retargetFade_(durationMs, curve)) {
 
-          DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, " 🔉 %s - Current volume is already at target. No fade needed.", __PRETTY_FUNCTION__);
-
-          return;
-        }
-
-        int volumeDifference = abs(targetVolume - currentVolume);
-        fadeIntervalMs = constrain(durationMs / volumeDifference, 10, 500); // Interval between 10ms and 500ms
-        volumeStep = 1;
-
-        lastFadeTime = millis();
-
-        DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🎚️🔢 %s - Fade calculation: Volume step: %d, Fade interval: %d ms", __PRETTY_FUNCTION__, volumeStep, fadeIntervalMs);
+      DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, " 🔉 %s - Current volume is already at target. No fade needed.", __PRETTY_FUNCTION__);
 
     } else {
 
-      DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🎚️ %s - Fade already in progress, ignoring new fade request", __PRETTY_FUNCTION__);
+      DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🎚️🔢 %s - Fade calculation: %u steps, step interval: %d ms", __PRETTY_FUNCTION__, (unsigned)fadeSteps, fadeIntervalMs);
 
     }
     displayPlayerStatusBox();
@@ -404,6 +677,72 @@ const char* PlayerController::fadeDirectionToString(FadeDirection direction) {
     }
 }
 
+/**
+ * @brief Arms a time-based fade from currentVolume to targetVolume.
+ *
+ * The fade is evaluated on a grid of fadeSteps ticks spread evenly over
+ * durationMs, never closer together than the backend's normalGapMs(), so every
+ * step can go out on the wire. A linear fade gets one tick per volume unit;
+ * curved fades get up to four, because their volume changes unevenly. With a
+ * slow link, intermediate volumes are skipped rather than the fade stretched.
+ *
+ * @param direction  FadeDirection::IN or FadeDirection::OUT
+ * @param durationMs Total fade time; the final step is due at fadeStartTime + durationMs
+ * @param curve      Volume-over-time shape (see PlayerFadeCurves.h)
+ */
+void PlayerController::beginFade_(FadeDirection direction, int durationMs, FadeCurve curve) {
+    const unsigned long now = millis();
+    const int volumeDifference = abs(targetVolume - currentVolume);
+    const int minTickMs = max((int)normalGapMs(), MIN_FADE_TICK_MS);
+    const int maxSteps = curve == FadeCurve::LINEAR ? volumeDifference : volumeDifference * 4;
+
+    _envelope = nullptr;  // a fade takes over from a running envelope
+    fadeDirection = direction;
+    fadeCurve = curve;
+    fadeStartTime = now;
+    lastFadeTime = now;
+    fadeStartVolume = currentVolume;
+    fadeDurationMs = (unsigned long)max(durationMs, 0);
+    fadeSteps = (uint8_t)constrain(min(maxSteps, durationMs / minTickMs), 1, 255);
+    fadeStepsDone = 0;
+    fadeIntervalMs = (int)(fadeDurationMs / fadeSteps);
+    _hardwareFade = fadeDurationMs > 0 && beginHardwareFade(targetVolume, fadeDurationMs, curve);
+}
+
+// Volume due at fade step `step` of fadeSteps. Linear fades are exact; curves
+// come from the compile-time tables, rounded to the nearest volume unit.
+int PlayerController::fadeVolumeAt_(uint8_t step) const {
+    const int delta = targetVolume - fadeStartVolume;
+    if (step >= fadeSteps) return targetVolume;
+    if (fadeCurve == FadeCurve::LINEAR) return fadeStartVolume + delta * step / fadeSteps;
+    const int applied = (abs(delta) * playerFadeCurveQ8(fadeCurve, step, fadeSteps, delta > 0) + 127) / 255;
+    return fadeStartVolume + (delta < 0 ? -applied : applied);
+}
+
+// (Re)arms a fade from currentVolume to targetVolume, in whichever direction
+// that is, over durationMs from now. A fadeIn() still waiting for its play
+// frame keeps waiting with the new parameters. Ends a running fade when the
+// volume is already at the target. Returns false when no fade is needed.
+bool PlayerController::retargetFade_(int durationMs, FadeCurve curve) {
+    if (_fadeInPlayTicket != 0) {
+        fadeDurationMs = (unsigned long)durationMs;
+        fadeCurve = curve;
+        return true;
+    }
+    if (currentVolume == targetVolume) {
+        if (fadeDirection != FadeDirection::NONE) stopFade(/*stopSound=*/fadeDirection == FadeDirection::OUT && shouldStopAfterFade);
+        return false;
+    }
+    beginFade_(currentVolume < targetVolume ? FadeDirection::IN : FadeDirection::OUT, durationMs, curve);
+    return true;
+}
+
+void PlayerController::noteFadeRetarget_(const char* caller) {
+    _fadeRetargets++;
+    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::FADE, "🎯 %s - Fade in progress (%s, volume %d -> %d), retargeting", caller,
+                fadeDirectionToString(fadeDirection), currentVolume, targetVolume);
+}
+
 /**
  * @brief Immediately stops any ongoing fade effect.
  *
@@ -417,18 +756,25 @@ const char* PlayerController::fadeDirectionToString(FadeDirection direction) {
  *       leaving the volume at whatever level it was when the method was called.
  */
 void PlayerController::stopFade(bool stopSound) {
+    PlayerLockGuard lock(_apiMutex);
     if (fadeDirection != FadeDirection::NONE) {
         // If we're fading out and stopSound is true, stop the playback
         if (fadeDirection == FadeDirection::OUT && stopSound) {
             this->stop();
         }
 
+        // A backend ramp would carry on to the target: hold it where we are
+        if (_hardwareFade) setVolume(currentVolume);
+        _hardwareFade = false;
+
         // Reset fade-related variables
         fadeDirection = FadeDirection::NONE;
         fadeStartTime = 0;
         lastFadeTime = 0;
         fadeIntervalMs = 0;
-        volumeStep = 0;
+        fadeSteps = 0;
+        fadeStepsDone = 0;
+        _fadeInPlayTicket = 0;
         shouldStopAfterFade = false;
 
         DEBUG_PRINT(DebugLevel::COMMANDS, "⏹️ %s - Fade stopped immediately. Current volume: %d", __PRETTY_FUNCTION__, currentVolume);
@@ -601,30 +947,523 @@ void PlayerController::displayPlayerStatusBox() {
   if (fadeDirection != FadeDirection::NONE) {
       Serial.printf("    │ Fade direction: %-44s|\n", (fadeDirection == FadeDirection::IN) ? "IN" : "OUT");
       Serial.printf("    │ Current volume: %d, Target volume: %-44d|\n", currentVolume, targetVolume);
+      char fadeStr[48];
+      snprintf(fadeStr, sizeof(fadeStr), "%lu ms left, %lu retargets%s",
+               _fadeInPlayTicket ? fadeDurationMs : fadeDurationMs - min(millis() - fadeStartTime, fadeDurationMs),
+               (unsigned long)_fadeRetargets, _hardwareFade ? ", ramped" : "");
+      Serial.printf("    │ Fade:           %-44s|\n", fadeStr);
   }
 
   Serial.println(F("    └─────────────────────────────────────────────────────────────┘"));
 }
 
+bool PlayerController::executePlayerCommandBase(uint8_t type, uint16_t a, uint16_t b) {
+  return submitPlayerCommandBase(type, a, b) != 0;
+}
+
+uint16_t PlayerController::submitPlayerCommandBase(uint8_t type, uint16_t a, uint16_t b,
+                                                   PlayerCommandCallback cb, void* userCtx) {
+  return submitCommand_(type, a, b, 0, cb, userCtx);
+}
+
+bool PlayerController::executePlayerCommandUntilBase(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs) {
+  return submitCommand_(type, a, b, validForMs, nullptr, nullptr) != 0;
+}
+
+uint16_t PlayerController::submitPlayerCommandUntilBase(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs,
+                                                        PlayerCommandCallback cb, void* userCtx) {
+  return submitCommand_(type, a, b, validForMs, cb, userCtx);
+}
+
+uint16_t PlayerController::submitCommand_(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs,
+                                          PlayerCommandCallback cb, void* userCtx) {
+  PlayerLockGuard lock(_apiMutex);
+  if (type == 0) return 0;
+  if (validForMs == 0) validForMs = _postValidForMs;
+  const uint32_t now = millis();
+  const uint32_t validUntilMs = now + validForMs;
+
+  // The module already has this setting and nothing queued will change it.
+  if (isUnchanged_(type, a, b, /*alsoQueued=*/true)) {
+    _cmdUnchanged++;
+    PendingCommand skipped {};
+    skipped.type   = type;
+    skipped.a      = a;
+    skipped.b      = b;
+    skipped.ticket = nextTicket_();
+    skipped.postMs = now;
+    skipped.cb     = cb;
+    skipped.cbCtx  = userCtx;
+    finish_(skipped, PlayerCommandStatus::Unchanged);
+    return skipped.ticket;
+  }
+
+  // Newest value wins for coalescable opcodes. Walk back from the tail and stop
+  // at a play command: a volume queued before a play must stay before it.
+  if (isCoalescableCommand(type)) {
+    for (int i = (int)_queueCount - 1; i >= 0; --i) {
+      PendingCommand& cmd = queueAt_((uint8_t)i);
+      if (cmd.type == type) {
+        mergeInto_(cmd, a, b, now, validForMs != 0, validUntilMs, cb, userCtx);
+        return cmd.ticket;
+      }
+      if (isPlayCommand(cmd.type)) break;
+    }
+  }
+
+  applyPeepholeRules_(type);
+
+  const PlayerCommandClass cls = commandClass(type);
+  if (isPlayCommand(type)) {
+    // The newest play wins: plays still waiting would only be cut off by it.
+    // Superseding them (rather than dropping this one when the Play class is
+    // full) keeps the module and playSoundSetStatus() on the same track.
+    for (int i = (int)_queueCount - 1; i >= 0; --i) {
+      if (!isPlayCommand(queueAt_((uint8_t)i).type)) continue;
+      const PendingCommand superseded = queueAt_((uint8_t)i);
+      removeQueued_((uint8_t)i);
+      finish_(superseded, PlayerCommandStatus::Superseded);
+    }
+    recoalesceQueued_();
+  }
+  // A play has just superseded every queued play, so only the queue size
+  // limits it; promoted settings in its class must not crowd it out.
+  if (_queueCount >= PLAYER_CMD_QUEUE_SIZE ||
+      (!isPlayCommand(type) && countQueuedInClass_(cls) >= classDepth_(cls))) {
+    // Newest value wins: rather than dropping it, overwrite the newest queued
+    // value of the same opcode, even across a play (the end state is right,
+    // only sooner than asked).
+    if (isCoalescableCommand(type)) {
+      for (int i = (int)_queueCount - 1; i >= 0; --i) {
+        PendingCommand& cmd = queueAt_((uint8_t)i);
+        if (cmd.type != type) continue;
+        mergeInto_(cmd, a, b, now, validForMs != 0, validUntilMs, cb, userCtx);
+        return cmd.ticket;
+      }
+    }
+    _cmdDropped++;
+    return 0;
+  }
+
+  if (cls == PlayerCommandClass::Urgent) {
+    // A stop makes every play still waiting in the queue pointless.
+    for (int i = (int)_queueCount - 1; i >= 0; --i) {
+      if (!isPlayCommand(queueAt_((uint8_t)i).type)) continue;
+      const PendingCommand cancelled = queueAt_((uint8_t)i);
+      removeQueued_((uint8_t)i);
+      finish_(cancelled, PlayerCommandStatus::Superseded);
+    }
+    recoalesceQueued_();
+  } else if (cls == PlayerCommandClass::Play) {
+    // Play is an ordering barrier: volume/EQ/loop queued before it must reach
+    // the module first, so promote them into the play class.
+    for (uint8_t i = 0; i < _queueCount; ++i) {
+      PendingCommand& cmd = queueAt_(i);
+      if (cmd.cls > PlayerCommandClass::Play) cmd.cls = PlayerCommandClass::Play;
+    }
+  }
+
+  PendingCommand& slot = queueAt_(_queueCount);
+  slot.type         = type;
+  slot.cls          = cls;
+  slot.a            = a;
+  slot.b            = b;
+  slot.ticket       = nextTicket_();
+  slot.postMs       = now;
+  slot.hasDeadline  = validForMs != 0;
+  slot.validUntilMs = validUntilMs;
+  slot.cb           = cb;
+  slot.cbCtx        = userCtx;
+  _queueCount++;
+  return slot.ticket;
+}
+
+bool PlayerController::isCommandPending(uint16_t ticket) const {
+  PlayerLockGuard lock(_apiMutex);
+  if (ticket == 0) return false;
+  for (uint8_t i = 0; i < _queueCount; ++i) {
+    if (queueAt_(i).ticket == ticket) return true;
+  }
+  return false;
+}
+
+void PlayerController::removeQueued_(uint8_t i) {
+  for (; i + 1 < _queueCount; ++i) {
+    queueAt_(i) = queueAt_(i + 1);
+  }
+  _queueCount--;
+}
+
+// For every rule whose `second` is the opcode being queued, drop the newest
+// queued `first` unless a play sits between them (the play may depend on it,
+// e.g. loop mode set before a play).
+void PlayerController::applyPeepholeRules_(uint8_t type) {
+  uint8_t ruleCount = 0;
+  const PlayerPeepholeRule* rules = peepholeRules(ruleCount);
+  for (uint8_t r = 0; r < ruleCount; ++r) {
+    if (rules[r].second != type) continue;
+    for (int i = (int)_queueCount - 1; i >= 0; --i) {
+      const PendingCommand& cmd = queueAt_((uint8_t)i);
+      if (cmd.type == rules[r].first) {
+        const PendingCommand elided = cmd;
+        removeQueued_((uint8_t)i);
+        _cmdElided++;
+        finish_(elided, PlayerCommandStatus::Elided);
+        break;
+      }
+      if (isPlayCommand(cmd.type)) break;
+    }
+  }
+}
+
+// Replaces a queued command's value with a newer one of the same opcode. The
+// old ticket finishes as Merged; the entry keeps its place and class.
+void PlayerController::mergeInto_(PendingCommand& cmd, uint16_t a, uint16_t b, uint32_t now,
+                                  bool hasDeadline, uint32_t validUntilMs, PlayerCommandCallback cb, void* userCtx) {
+  finish_(cmd, PlayerCommandStatus::Merged);
+  cmd.a            = a;
+  cmd.b            = b;
+  cmd.ticket       = nextTicket_();
+  cmd.postMs       = now;
+  cmd.hasDeadline  = hasDeadline;
+  cmd.validUntilMs = validUntilMs;
+  cmd.cb           = cb;
+  cmd.cbCtx        = userCtx;
+  _cmdMerged++;
+}
+
+// After plays were removed from the queue, values of a coalescable opcode that
+// a play used to keep apart may now sit next to each other: keep the newest,
+// the older ones finish as Merged.
+void PlayerController::recoalesceQueued_() {
+  for (int j = (int)_queueCount - 1; j > 0; --j) {
+    const uint8_t type = queueAt_((uint8_t)j).type;
+    if (!isCoalescableCommand(type)) continue;
+    for (int i = j - 1; i >= 0; --i) {
+      const PendingCommand& cmd = queueAt_((uint8_t)i);
+      if (isPlayCommand(cmd.type)) break;
+      if (cmd.type != type) continue;
+      const PendingCommand merged = cmd;
+      removeQueued_((uint8_t)i);
+      _cmdMerged++;
+      finish_(merged, PlayerCommandStatus::Merged);
+      --j;  // the newer entry moved down one slot
+    }
+  }
+}
+
+// By the class each entry is queued in: settings a play promoted count
+// against the play class, not their own.
+uint8_t PlayerController::countQueuedInClass_(PlayerCommandClass cls) const {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < _queueCount; ++i) {
+    if (queueAt_(i).cls == cls) n++;
+  }
+  return n;
+}
+
+// Bounded per-class depth so a flood in one class cannot starve the others of
+// queue slots. Bulk (volume) coalesces, so it rarely needs more than one slot.
+uint8_t PlayerController::classDepth_(PlayerCommandClass cls) {
+  switch (cls) {
+    case PlayerCommandClass::Urgent:  return 2;
+    case PlayerCommandClass::Play:    return 2;
+    case PlayerCommandClass::Control: return 4;
+    case PlayerCommandClass::Bulk:    return 2;
+    default:                          return PLAYER_CMD_QUEUE_SIZE;
+  }
+}
+
+void PlayerController::finish_(const PendingCommand& cmd, PlayerCommandStatus status, uint16_t gapMs) {
+  traceRecord_(cmd, status, gapMs);
+#if PLAYER_LATENCY_HISTOGRAMS
+  if (status == PlayerCommandStatus::Sent && cmd.type < PLAYER_MAX_OPCODES) {
+    _postToWire[cmd.type].record(millis() - cmd.postMs);
+  }
+#endif
+  if (!cmd.cb) return;
+  if (_inUpdate || _callbackCount >= PLAYER_CALLBACK_QUEUE_SIZE) {
+    cmd.cb(cmd.ticket, status, cmd.cbCtx);
+    return;
+  }
+  _callbacks[_callbackCount++] = { cmd.cb, cmd.cbCtx, cmd.ticket, status };
+}
+
+// In order of the outcomes; a callback may post again (it lands in the queue,
+// and its own callbacks fire directly, since update() is running).
+void PlayerController::deliverCallbacks_() {
+  for (uint8_t i = 0; i < _callbackCount; ++i) {
+    const PendingCallback pending = _callbacks[i];
+    pending.cb(pending.ticket, pending.status, pending.cbCtx);
+  }
+  _callbackCount = 0;
+}
+
+void PlayerController::traceRecord_(const PendingCommand& cmd, PlayerCommandStatus status, uint16_t gapMs) {
+#if PLAYER_TRACE_SIZE > 0
+  const uint32_t delta = millis() - cmd.postMs;
+  PlayerTraceRecord& rec = _trace[(_traceHead + _traceCount) % TRACE_CAPACITY];
+  rec.postMs      = cmd.postMs;
+  rec.sendDeltaMs = delta > 0xFFFF ? 0xFFFF : (uint16_t)delta;
+  rec.gapMs       = gapMs;
+  rec.a           = cmd.a;
+  rec.b           = cmd.b;
+  rec.type        = cmd.type;
+  rec.status      = (uint8_t)status;
+  rec.queueDepth  = _queueCount;
+  if (_traceCount < PLAYER_TRACE_SIZE) {
+    _traceCount++;
+  } else {
+    _traceHead = (_traceHead + 1) % PLAYER_TRACE_SIZE;  // overwrite the oldest
+    _traceOverwritten++;
+  }
+#else
+  (void)cmd; (void)status; (void)gapMs;
+#endif
+}
+
+bool PlayerController::getTraceRecord(uint8_t i, PlayerTraceRecord& out) const {
+  PlayerLockGuard lock(_apiMutex);
+  if (i >= _traceCount) return false;
+  out = _trace[(_traceHead + i) % TRACE_CAPACITY];
+  return true;
+}
+
+void PlayerController::noteWireToStatusLatency(uint8_t type, uint32_t ms) {
+#if PLAYER_LATENCY_HISTOGRAMS
+  PlayerLockGuard lock(_apiMutex);
+  if (type < PLAYER_MAX_OPCODES) _wireToStatus[type].record(ms);
+#else
+  (void)type; (void)ms;
+#endif
+}
+
+const PlayerLatencyHistogram* PlayerController::getPostToWireHistogram(uint8_t type) const {
+#if PLAYER_LATENCY_HISTOGRAMS
+  return type < PLAYER_MAX_OPCODES ? &_postToWire[type] : nullptr;
+#else
+  (void)type;
+  return nullptr;
+#endif
+}
+
+const PlayerLatencyHistogram* PlayerController::getWireToStatusHistogram(uint8_t type) const {
+#if PLAYER_LATENCY_HISTOGRAMS
+  return type < PLAYER_MAX_OPCODES ? &_wireToStatus[type] : nullptr;
+#else
+  (void)type;
+  return nullptr;
+#endif
+}
+
+void PlayerController::resetLatencyHistograms() {
+#if PLAYER_LATENCY_HISTOGRAMS
+  PlayerLockGuard lock(_apiMutex);
+  for (uint8_t i = 0; i < PLAYER_MAX_OPCODES; ++i) {
+    _postToWire[i]   = PlayerLatencyHistogram();
+    _wireToStatus[i] = PlayerLatencyHistogram();
+  }
+#endif
+}
+
+#if PLAYER_LATENCY_HISTOGRAMS
+static void printHistogram_(Print& out, const char* kind, const char* name, const PlayerLatencyHistogram& h) {
+  out.print(F("[LAT] ")); out.print(kind); out.print(' '); out.print(name);
+  out.print(F(" n="));    out.print(h.count);
+  out.print(F(" mean=")); out.print(h.meanMs());
+  out.print(F(" p50<=")); out.print(h.percentileMs(50));
+  out.print(F(" p90<=")); out.print(h.percentileMs(90));
+  out.print(F(" p99<=")); out.print(h.percentileMs(99));
+  out.print(F(" max="));  out.print(h.maxMs);
+  out.print(F(" |"));
+  for (uint8_t i = 0; i < PlayerLatencyHistogram::BUCKETS; ++i) {
+    out.print(' '); out.print(h.bucket[i]);
+  }
+  out.println();
+}
+#endif
+
+// One line per opcode with samples; the trailing columns are the raw bucket
+// counts for 0, 1, 2-3, 4-7, ... , >=1024 ms.
+void PlayerController::printLatencyHistograms(Print& out) const {
+#if PLAYER_LATENCY_HISTOGRAMS
+  PlayerLockGuard lock(_apiMutex);
+  for (uint8_t t = 0; t < PLAYER_MAX_OPCODES; ++t) {
+    if (_postToWire[t].count)   printHistogram_(out, "post->wire  ", cmdName(t), _postToWire[t]);
+    if (_wireToStatus[t].count) printHistogram_(out, "wire->status", cmdName(t), _wireToStatus[t]);
+  }
+#else
+  out.println(F("[LAT] histograms disabled (PLAYER_LATENCY_HISTOGRAMS false)"));
+#endif
+}
+
+static void printHex_(Print& out, uint32_t value, uint8_t bytes) {
+  static const char digits[] = "0123456789abcdef";
+  for (uint8_t i = 0; i < bytes; ++i) {  // little-endian byte order
+    const uint8_t b = (uint8_t)(value >> (8 * i));
+    out.print(digits[b >> 4]);
+    out.print(digits[b & 0x0F]);
+  }
+}
+
+// Format (version 2), one record per line as 15 little-endian bytes in hex:
+//   postMs:4 sendDeltaMs:2 gapMs:2 a:2 b:2 type:1 status:1 queueDepth:1
+// framed by a "#PTRACE" header, "#op <type> <name>" legend lines and "#END".
+void PlayerController::dumpTrace(Print& out, bool clear) {
+  PlayerLockGuard lock(_apiMutex);
+  out.print(F("#PTRACE 2 ")); out.print(getPlayerTypeName());
+  out.print(F(" now=")); out.print(millis());
+  out.print(F(" n=")); out.print(_traceCount);
+  out.print(F(" overwritten=")); out.println(_traceOverwritten);
+  for (uint8_t t = 1; t < PLAYER_MAX_OPCODES; ++t) {
+    const char* name = cmdName(t);
+    if (!name || strchr(name, '?')) continue;
+    out.print(F("#op ")); out.print(t); out.print(' '); out.println(name);
+  }
+  for (uint8_t i = 0; i < _traceCount; ++i) {
+    const PlayerTraceRecord& rec = _trace[(_traceHead + i) % TRACE_CAPACITY];
+    printHex_(out, rec.postMs, 4);
+    printHex_(out, rec.sendDeltaMs, 2);
+    printHex_(out, rec.gapMs, 2);
+    printHex_(out, rec.a, 2);
+    printHex_(out, rec.b, 2);
+    printHex_(out, rec.type, 1);
+    printHex_(out, rec.status, 1);
+    printHex_(out, rec.queueDepth, 1);
+    out.println();
+  }
+  out.println(F("#END"));
+  if (clear) clearTrace();
+}
+
+bool PlayerController::refreshExpiredCommand(uint8_t type, uint16_t& a, uint16_t& b) const {
+  PlayerStateKey key;
+  uint16_t value;
+  if (!commandStateEffect(type, a, b, key, value) || key != PlayerStateKey::Volume) return false;
+  a = (uint16_t)constrain(currentVolume, MIN_VOLUME, MAX_VOLUME);
+  return true;
+}
+
+// True when `type` writes a setting whose shadow value is known and equal to
+// the new one. With alsoQueued, a queued command touching the same setting
+// (which may still change it first) makes the write necessary again.
+bool PlayerController::isUnchanged_(uint8_t type, uint16_t a, uint16_t b, bool alsoQueued) const {
+  PlayerStateKey key;
+  uint16_t value;
+  if (!commandStateEffect(type, a, b, key, value)) return false;
+  const uint8_t k = (uint8_t)key;
+  if (k >= (uint8_t)PlayerStateKey::Count || !(_shadowKnown & (1u << k))) return false;
+  if (_shadowValue[k] != value) return false;
+  return !(alsoQueued && hasPendingState_(key));
+}
+
+bool PlayerController::hasPendingState_(PlayerStateKey key) const {
+  for (uint8_t i = 0; i < _queueCount; ++i) {
+    const PendingCommand& cmd = queueAt_(i);
+    PlayerStateKey k;
+    uint16_t value;
+    if (commandStateEffect(cmd.type, cmd.a, cmd.b, k, value) && k == key) return true;
+  }
+  return false;
+}
+
+void PlayerController::noteShadowState(PlayerStateKey key, uint16_t value) {
+  const uint8_t k = (uint8_t)key;
+  if (k >= (uint8_t)PlayerStateKey::Count) return;
+  _shadowValue[k] = value;
+  _shadowKnown |= (uint8_t)(1u << k);
+}
+
+void PlayerController::forgetShadowState(PlayerStateKey key) {
+  const uint8_t k = (uint8_t)key;
+  if (k >= (uint8_t)PlayerStateKey::Count) return;
+  _shadowKnown &= (uint8_t)~(1u << k);
+}
+
+bool PlayerController::getShadowState(PlayerStateKey key, uint16_t& value) const {
+  const uint8_t k = (uint8_t)key;
+  if (k >= (uint8_t)PlayerStateKey::Count || !(_shadowKnown & (1u << k))) return false;
+  value = _shadowValue[k];
+  return true;
+}
+
+// The only path from the queue to the wire: the shadow follows what was sent.
+// Noted first, so sendCommand() can still forget a value that lands later.
+void PlayerController::sendTracked_(uint8_t type, uint16_t a, uint16_t b) {
+  PlayerStateKey key;
+  uint16_t value;
+  if (commandStateEffect(type, a, b, key, value)) noteShadowState(key, value);
+  sendCommand(type, a, b);
+}
+
+bool PlayerController::hasPendingCommand(uint8_t type) const {
+  for (uint8_t i = 0; i < _queueCount; ++i) {
+    if (queueAt_(i).type == type) return true;
+  }
+  return false;
+}
+
+void PlayerController::drainMailbox_() {
+  uint8_t  type;
+  uint16_t a, b;
+  while (_mailbox.take(type, a, b)) {
+    submitPlayerCommandBase(type, a, b);  // counts a drop when the queue is full
+  }
+}
+
 void PlayerController::flushPendingIfReadyBase_() {
+  PlayerLockGuard lock(_apiMutex);
+  drainMailbox_();
   const uint32_t now = millis();
-  if (_pendingType == 0) return;
+  if (_queueCount == 0) return;
   if ((int32_t)(now - _nextReadyMs) < 0) return;
 
-  const uint8_t  t = _pendingType;
-  const uint16_t a = _pendingA;
-  const uint16_t b = _pendingB;
-  _pendingType = 0;  // clear before sending
+  // Most urgent class first, oldest first within a class. Pop the entry before
+  // sending (sendCommand may post follow-ups). Entries that would not change
+  // the module state cost no wire time, so the next one is tried right away.
+  while (_queueCount != 0) {
+    uint8_t pick = 0;
+    for (uint8_t i = 1; i < _queueCount; ++i) {
+      if (queueAt_(i).cls < queueAt_(pick).cls) pick = i;
+    }
+    PendingCommand cmd = queueAt_(pick);
+    if (pick == 0) {
+      _queueHead = (_queueHead + 1) % PLAYER_CMD_QUEUE_SIZE;
+      _queueCount--;
+    } else {
+      removeQueued_(pick);
+    }
 
-  sendCommand(t, a, b);
+    // Too late: send the current desired state instead, or nothing.
+    if (cmd.hasDeadline && (int32_t)(now - cmd.validUntilMs) > 0) {
+      if (!refreshExpiredCommand(cmd.type, cmd.a, cmd.b)) {
+        _cmdExpired++;
+        finish_(cmd, PlayerCommandStatus::Expired);
+        continue;
+      }
+      _cmdRefreshed++;
+    }
 
-  const uint16_t gap = isPlayCommand(t) ? afterPlayGapMs() : normalGapMs();
-  _nextReadyMs = now + gap;
+    if (isUnchanged_(cmd.type, cmd.a, cmd.b)) {
+      _cmdUnchanged++;
+      finish_(cmd, PlayerCommandStatus::Unchanged);
+      continue;
+    }
 
-  debugSend_(t, a, b, now, gap);
+    sendTracked_(cmd.type, cmd.a, cmd.b);
+
+    const uint16_t gap = commandGapMs(cmd.type);
+    _nextReadyMs = now + gap;
+
+    debugSend_(cmd.type, cmd.a, cmd.b, now, gap);
+
+    finish_(cmd, PlayerCommandStatus::Sent, gap);
+    return;
+  }
 }
 
 void PlayerController::executePlayerCommandNowBase(uint8_t type, uint16_t a, uint16_t b) {
+  PlayerLockGuard lock(_apiMutex);
   // NOTE: this can run inside the ESP-NOW receive callback (SYS context on
   // ESP8266) — a FE play/stop arrives as a cmd message and routes here. In that
   // context Arduino delay()/yield() call esp_yield(), which is illegal and
@@ -634,46 +1473,213 @@ void PlayerController::executePlayerCommandNowBase(uint8_t type, uint16_t a, uin
   // waits so the pacing is identical but safe from any context. The spin is
   // bounded by the pacing gap (tens to a few hundred ms), well under the WDT.
 
+  PendingCommand direct {};  // traced like a queued command, no ticket/callback
+  direct.type   = type;
+  direct.a      = a;
+  direct.b      = b;
+  direct.postMs = millis();
+
   // Drain any previously queued command first to preserve wire-order semantics.
-  while (_pendingType != 0) {
+  drainMailbox_();
+  while (_queueCount != 0) {
     flushPendingIfReadyBase_();
-    if (_pendingType != 0) {
+    if (_queueCount != 0) {
       /* spin, no yield (see note above) */
     }
   }
 
+  if (isUnchanged_(type, a, b)) {
+    _cmdUnchanged++;
+    finish_(direct, PlayerCommandStatus::Unchanged);
+    return;
+  }
+
   // Respect command pacing gap for direct deterministic send.
   while ((int32_t)(millis() - _nextReadyMs) < 0) {
     /* spin, no yield (see note above) */
   }
 
   const uint32_t now = millis();
-  sendCommand(type, a, b);
+  sendTracked_(type, a, b);
 
-  const uint16_t gap = isPlayCommand(type) ? afterPlayGapMs() : normalGapMs();
+  const uint16_t gap = commandGapMs(type);
   _nextReadyMs = now + gap;
   debugSend_(type, a, b, now, gap);
+  finish_(direct, PlayerCommandStatus::Sent, gap);
+}
+
+uint16_t PlayerController::commandGapMs(uint8_t type) const {
+  if (_adaptiveGaps && type < PLAYER_MAX_OPCODES && _learnedGapMs[type] != 0) {
+    return _learnedGapMs[type];
+  }
+  return isPlayCommand(type) ? afterPlayGapMs() : normalGapMs();
+}
+
+bool PlayerController::calibrateCommandGaps(int testTrack, uint8_t rounds) {
+  PlayerLockGuard lock(_apiMutex);
+  CalibrationCommand cmds[8];
+  const uint8_t count = calibrationCommands(cmds, sizeof(cmds) / sizeof(cmds[0]), testTrack);
+  if (count == 0 || rounds == 0) {
+    DEBUG_PRINT(DebugLevel::SETUP, "⏱️ %s - %s has no calibration feedback path", __PRETTY_FUNCTION__, getPlayerTypeName());
+    return false;
+  }
+
+  // Calibration owns the wire: flush what is queued, then measure each command
+  // with the conservative default gap in between so runs do not overlap.
+  while (_queueCount != 0) flushPendingIfReadyBase_();
+
+  bool learnedAny = false;
+  for (uint8_t i = 0; i < count; ++i) {
+    const CalibrationCommand& cmd = cmds[i];
+    if (cmd.type >= PLAYER_MAX_OPCODES) continue;
+    const uint16_t defaultGap = isPlayCommand(cmd.type) ? afterPlayGapMs() : normalGapMs();
+
+    uint16_t worstMs = 0;
+    bool ok = true;
+    for (uint8_t r = 0; r < rounds && ok; ++r) {
+      while ((int32_t)(millis() - _nextReadyMs) < 0) { delay(1); }
+      uint16_t elapsedMs = 0;
+      ok = probeCommandLatency(cmd.type, cmd.a, cmd.b, elapsedMs);
+      _nextReadyMs = millis() + defaultGap;
+      if (ok) noteWireToStatusLatency(cmd.type, elapsedMs);
+      if (ok && elapsedMs > worstMs) worstMs = elapsedMs;
+    }
+
+    if (!ok) {
+      DEBUG_PRINT(DebugLevel::SETUP, "⏱️ %s - %s: no response, keeping default %u ms", __PRETTY_FUNCTION__, cmdName(cmd.type), defaultGap);
+      continue;
+    }
+
+    uint32_t learned = worstMs + (uint32_t)worstMs * PLAYER_GAP_CALIBRATION_MARGIN_PCT / 100 + PLAYER_GAP_CALIBRATION_MARGIN_MS;
+    learned = constrain(learned, (uint32_t)PLAYER_GAP_CALIBRATION_MARGIN_MS, (uint32_t)1000);
+    _learnedGapMs[cmd.type] = (uint16_t)learned;
+    learnedAny = true;
+
+    DEBUG_PRINT(DebugLevel::SETUP, "⏱️ %s - %s: worst %u ms => gap %u ms (default %u ms)", __PRETTY_FUNCTION__, cmdName(cmd.type), worstMs, (uint16_t)learned, defaultGap);
+  }
+
+  // Probes write settings outside the queue; the shadow no longer reflects them.
+  invalidateShadowState();
+
+  if (learnedAny) _adaptiveGaps = true;
+  return learnedAny;
+}
+
+uint16_t PlayerController::getPlayStartLatencyMs() const {
+  return _playStartLatencyMs != PLAY_START_LATENCY_UNSET ? _playStartLatencyMs : playStartLatencyMs();
+}
+
+void PlayerController::setBusyPin(int8_t pin, bool activeLow) {
+  _busyPin = pin;
+  _busyActiveLow = activeLow;
+  if (pin >= 0) pinMode(pin, INPUT_PULLUP);
+}
+
+// Plays testTrack through the normal path and times post -> BUSY active.
+bool PlayerController::probePlayStartBusy_(int testTrack, uint16_t& elapsedMs) {
+  const uint32_t start = millis();
+  playTrack(testTrack, 0, "calibration");
+  while ((int32_t)(millis() - start) < 2000) {
+    flushPendingIfReadyBase_();
+    if ((digitalRead(_busyPin) == LOW) == _busyActiveLow) {
+      elapsedMs = (uint16_t)(millis() - start);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PlayerController::calibratePlayStartLatency(int testTrack, uint8_t rounds) {
+  PlayerLockGuard lock(_apiMutex);
+  uint16_t samples[8];
+  rounds = min(rounds, (uint8_t)(sizeof(samples) / sizeof(samples[0])));
+  if (testTrack <= 0 || rounds == 0) return false;
+
+  // Calibration owns the wire (see calibrateCommandGaps()).
+  while (_queueCount != 0) flushPendingIfReadyBase_();
+
+  uint8_t n = 0;
+  for (uint8_t r = 0; r < rounds; ++r) {
+    while ((int32_t)(millis() - _nextReadyMs) < 0) { delay(1); }
+    uint16_t elapsedMs = 0;
+    const bool ok = _busyPin >= 0 ? probePlayStartBusy_(testTrack, elapsedMs) : probePlayStart(testTrack, elapsedMs);
+    _nextReadyMs = millis() + afterPlayGapMs();
+    stop();
+    while (_queueCount != 0) flushPendingIfReadyBase_();
+    delay(300);  // let the module settle (and BUSY release) before the next round
+    if (!ok) break;
+    samples[n++] = elapsedMs;
+  }
+  invalidateShadowState();  // probes write outside the queue
+
+  if (n == 0) {
+    DEBUG_PRINT(DebugLevel::SETUP, "⏱️ %s - %s: no play-start feedback (BUSY pin or status query), keeping %u ms",
+                __PRETTY_FUNCTION__, getPlayerTypeName(), getPlayStartLatencyMs());
+    return false;
+  }
+  // Median: one slow SD seek should not move every scheduled start.
+  for (uint8_t i = 1; i < n; ++i) {
+    for (uint8_t j = i; j > 0 && samples[j - 1] > samples[j]; --j) {
+      const uint16_t t = samples[j]; samples[j] = samples[j - 1]; samples[j - 1] = t;
+    }
+  }
+  _playStartLatencyMs = samples[n / 2];
+  DEBUG_PRINT(DebugLevel::SETUP, "⏱️ %s - %s: play start %u ms (median of %u, typical %u ms)",
+              __PRETTY_FUNCTION__, getPlayerTypeName(), _playStartLatencyMs, n, playStartLatencyMs());
+  return true;
+}
+
+// FNV-1a over the player type name, so a stored profile is not applied to a
+// different module type.
+uint32_t PlayerController::playerTypeHash_() const {
+  uint32_t hash = 2166136261UL;
+  for (const char* p = getPlayerTypeName(); *p; ++p) {
+    hash = (hash ^ (uint8_t)*p) * 16777619UL;
+  }
+  return hash;
+}
+
+void PlayerController::exportGapProfile(PlayerGapProfile& profile) const {
+  profile.magic = PlayerGapProfile::MAGIC;
+  profile.playerTypeHash = playerTypeHash_();
+  for (uint8_t i = 0; i < PLAYER_MAX_OPCODES; ++i) profile.gapMs[i] = _learnedGapMs[i];
+}
+
+bool PlayerController::importGapProfile(const PlayerGapProfile& profile) {
+  if (profile.magic != PlayerGapProfile::MAGIC || profile.playerTypeHash != playerTypeHash_()) {
+    return false;
+  }
+  for (uint8_t i = 0; i < PLAYER_MAX_OPCODES; ++i) _learnedGapMs[i] = profile.gapMs[i];
+  _adaptiveGaps = true;
+  return true;
+}
+
+void PlayerController::clearLearnedGaps() {
+  for (uint8_t i = 0; i < PLAYER_MAX_OPCODES; ++i) _learnedGapMs[i] = 0;
+  _adaptiveGaps = false;
+}
+
+bool PlayerController::startServiceTask(uint16_t tickMs, uint8_t priority, int8_t core) {
+    _apiMutex.create();
+    return _serviceTask.start(&PlayerController::serviceTick_, this, tickMs, priority, core);
 }
 
 void PlayerController::update() {
+    PlayerLockGuard lock(_apiMutex);
     unsigned long currentTime = millis();
 
-    // Deferred/scheduled play (syncPlaySound). Overflow-safe deadline check,
-    // identical to the syncTrigger pattern. Runs first so the freshly-started
-    // track's playStartTime/playDuration are evaluated on subsequent loops.
-    if (_syncPlayPending && (currentTime - _syncPlayFireAtMs) < 0x80000000UL) {
-        _syncPlayPending = false;            // clear before play => no double-fire
-        if (isFading()) stopFade(/*stopSound=*/false);  // match live playSound path
-        if (_syncPlayVolume >= 0) setVolume(_syncPlayVolume);
-        playTrack(_syncPlayTrack, _syncPlayDuration, _syncPlayName);
-        DEBUG_PRINT(DebugLevel::COMMANDS, "⏱️▶️ %s - syncPlaySound fired track=%d", __PRETTY_FUNCTION__, _syncPlayTrack);
-    }
+    // From here on callbacks fire directly; first the ones held since the last tick.
+    const bool nested = _inUpdate;
+    _inUpdate = true;
+    deliverCallbacks_();
 
-    // Define a static variable lastPlayerStatus to store the last player status
-    // This variable retains its value between function calls
-    // It is only accessible within this update() method
-    // It is initialized only once, when the function is first called
-    static PlayerStatus lastPlayerStatus = STATUS_STOPPED;
+    // Scheduled actions (schedulePlay() & co.). Only the timeline head is
+    // compared with the clock; everything due fires in time order, popped
+    // before it runs => no double-fire. Runs first so a freshly-started
+    // track's playStartTime/playDuration are evaluated on subsequent loops.
+    ScheduledAction action;
+    uint32_t fireAtMs;
+    while (_timeline.popDue(currentTime, action, &fireAtMs)) fireScheduled_(action, fireAtMs);
 
     // Periodic update
     #if DISPLAY_PLAYER_STATUS_PERIODIC == true
@@ -688,43 +1694,73 @@ void PlayerController::update() {
     }
     #endif
 
-    // Check if sound is playing and duration is set
-    if (playerStatus == STATUS_PLAYING && playDuration > 0) {
+    // Check if sound is playing and duration is set. A queued next track
+    // takes over leadMs before the end; one the backend chains waits for the
+    // end of the file instead.
+    if (playerStatus == STATUS_PLAYING && playDuration > 0 && !_next.chained) {
         unsigned long elapsedTime = currentTime - playStartTime;
 
-        if (elapsedTime >= playDuration) {
+        if (_next.queued && elapsedTime + _next.leadMs >= playDuration) {
+            playQueuedNextTrack_();
+        } else if (elapsedTime >= playDuration) {
 
           DEBUG_PRINT(DebugLevel::COMMANDS, "🏁 %s - Sound finished playing. Duration: %lu ms, New playerStatus: %s", __PRETTY_FUNCTION__, playDuration, playerStatusToString(playerStatus));
 
-          stopSoundSetStatus();
+          stopSoundSetStatus(/*endOfTrack=*/true);
         }
     }
 
-    // Handle fading
-    if (fadeDirection != FadeDirection::NONE && currentTime - lastFadeTime >= fadeIntervalMs) {
-        lastFadeTime = currentTime;
+    // Handle fading. The step is derived from the time since fadeStartTime, so
+    // a late update() skips straight to the volume that is due instead of
+    // stretching the fade; the last step always lands on the target.
+    if (_fadeInPlayTicket != 0 && !isCommandPending(_fadeInPlayTicket)) {
+        _fadeInPlayTicket = 0;
+        if (isSoundPlaying()) {
+            beginFade_(targetVolume >= currentVolume ? FadeDirection::IN : FadeDirection::OUT, (int)fadeDurationMs, fadeCurve);
 
-        int newVolume = currentVolume;
-        if (fadeDirection == FadeDirection::IN) {
-            newVolume = min(currentVolume + volumeStep, targetVolume);
-        } else if (fadeDirection == FadeDirection::OUT) {
-            newVolume = max(currentVolume - volumeStep, targetVolume);
+            DEBUG_PRINT(DebugLevel::FADE, "📈▶️ FADE - Play sent, fade in started: %u steps, step interval: %d ms", (unsigned)fadeSteps, fadeIntervalMs);
+        } else {
+            stopFade();  // stopped before the play went out: nothing to ramp
         }
+    }
+    uint8_t fadeStepDue = 0;
+    if (fadeDirection != FadeDirection::NONE && _fadeInPlayTicket == 0) {
+        const unsigned long fadeElapsed = currentTime - fadeStartTime;
+        if (fadeElapsed >= fadeDurationMs || fadeIntervalMs <= 0) {
+            fadeStepDue = fadeSteps;
+        } else {
+            fadeStepDue = (uint8_t)min(fadeElapsed / (unsigned long)fadeIntervalMs, (unsigned long)(fadeSteps - 1));
+        }
+    }
+    if (fadeStepDue > fadeStepsDone) {
+        lastFadeTime = currentTime;
+        fadeStepsDone = fadeStepDue;
 
+        int newVolume = fadeVolumeAt_(fadeStepsDone);
         newVolume = constrain(newVolume, MIN_VOLUME, MAX_VOLUME);
 
-        if (newVolume != currentVolume) {
+        if (_hardwareFade) {
+          // The backend ramps the audio itself; follow it, and confirm the
+          // target at the end (skipped on the wire once the backend has seen
+          // its ramp arrive there and nothing overrode it).
+          if (fadeStepsDone >= fadeSteps) setVolume(newVolume);
+          currentVolume = newVolume;
+        } else if (newVolume != currentVolume) {
 
           // TODO Only print this when `DebugLevel::REALTIME` and `DebugLevel::FADE` is set
           DEBUG_PRINT_AND(DebugLevel::REALTIME | DebugLevel::FADE, "📈🔊 - FADE - Changing volume from %d to %d (Target: %d, Direction: %s)", currentVolume, newVolume, targetVolume, fadeDirection == FadeDirection::IN ? "IN" : "OUT");
           DEBUG_PRINT_AND(DebugLevel::REALTIME | DebugLevel::FADE, "📈➡️ - FadeDirection: %s", fadeDirectionToString(fadeDirection));
 
+          // A fade step is stale once the next one is due; if the link is
+          // backed up it is refreshed to the fade's volume at send time.
+          _postValidForMs = (uint16_t)min(fadeIntervalMs, 0xFFFF);
           setVolume(newVolume);
+          _postValidForMs = 0;
           currentVolume = newVolume;
         }
 
         // Check if fade is complete
-        if (currentVolume == targetVolume) {
+        if (fadeStepsDone >= fadeSteps) {
             // Check if we need to stop the sound before resetting fadeDirection
             if (fadeDirection == FadeDirection::OUT && shouldStopAfterFade) {
 
@@ -735,8 +1771,8 @@ void PlayerController::update() {
             }
 
             // Now set fadeDirection to NONE
-            FadeDirection previousFadeDirection = fadeDirection;
             fadeDirection = FadeDirection::NONE;
+            _hardwareFade = false;
 
             fadeDirection = FadeDirection::NONE;
             unsigned long totalFadeTime = currentTime - fadeStartTime;
@@ -746,8 +1782,15 @@ void PlayerController::update() {
         }
     }
 
+    updateEnvelope_(currentTime);
+
     // Check if player status has changed
     #if DISPLAY_PLAYER_STATUS_ENABLED == true
+    // Define a static variable lastPlayerStatus to store the last player status
+    // This variable retains its value between function calls
+    // It is only accessible within this update() method
+    // It is initialized only once, when the function is first called
+    static PlayerStatus lastPlayerStatus = STATUS_STOPPED;
     if (playerStatus != lastPlayerStatus) {
       Serial.println(F("    ┌───────────────────────────────────────────────────────┐"));
       char statusChangeStr[53]; // 53 characters + null terminator
@@ -763,4 +1806,5 @@ void PlayerController::update() {
 
     flushPendingIfReadyBase_();
 
+    _inUpdate = nested;
 }
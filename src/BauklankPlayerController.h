@@ -37,7 +37,67 @@
 #define DISPLAY_PLAYER_STATUS_PERIODIC false
 #endif
 
+#ifndef PLAYER_CMD_QUEUE_SIZE
+// Capacity of the ordered command queue drained by update() (max 255).
+#define PLAYER_CMD_QUEUE_SIZE 8
+#endif
+
+#ifndef PLAYER_CALLBACK_QUEUE_SIZE
+// Command callbacks raised outside update() (Merged, Superseded, ...) held for the next update().
+#define PLAYER_CALLBACK_QUEUE_SIZE 8
+#endif
+
+#ifndef PLAYER_CMD_MAILBOX_SIZE
+// Capacity of the lock-free ISR/cross-core mailbox (power of two).
+#define PLAYER_CMD_MAILBOX_SIZE 8
+#endif
+
+#ifndef PLAYER_CMD_MAILBOX_MULTI_PRODUCER
+// Allow several concurrent posting contexts (ISR + task + loop). Needs 32-bit
+// atomic compare-and-swap, which the ESP8266 toolchain does not provide.
+  #if defined(ESP8266)
+    #define PLAYER_CMD_MAILBOX_MULTI_PRODUCER false
+  #else
+    #define PLAYER_CMD_MAILBOX_MULTI_PRODUCER true
+  #endif
+#endif
+
+#ifndef PLAYER_MAX_OPCODES
+// Size of per-opcode tables (learned gaps, ...). Backend opcodes must be below this.
+#define PLAYER_MAX_OPCODES 16
+#endif
+
+#ifndef PLAYER_GAP_CALIBRATION_MARGIN_PCT
+// Safety margin added on top of the slowest measured command acceptance time.
+#define PLAYER_GAP_CALIBRATION_MARGIN_PCT 25
+#endif
+
+#ifndef PLAYER_GAP_CALIBRATION_MARGIN_MS
+// Fixed safety margin (ms) added after the percentage margin.
+#define PLAYER_GAP_CALIBRATION_MARGIN_MS 10
+#endif
+
+#ifndef PLAYER_TRACE_SIZE
+// Records kept in the binary command trace ring (max 255, 0 disables tracing).
+#define PLAYER_TRACE_SIZE 32
+#endif
+
+#ifndef PLAYER_TIMELINE_SIZE
+// Scheduled actions (schedulePlay(), scheduleStop(), ...) pending at once (max 254).
+#define PLAYER_TIMELINE_SIZE 16
+#endif
+
+#ifndef PLAYER_LATENCY_HISTOGRAMS
+// Per-opcode log2 latency histograms (post-to-wire, wire-to-status), ~1 KB RAM.
+#define PLAYER_LATENCY_HISTOGRAMS true
+#endif
+
 #include <stdint.h>
+#include "PlayerCommandMailbox.h"
+#include "PlayerEnvelope.h"
+#include "PlayerFadeCurves.h"
+#include "PlayerThreading.h"
+#include "PlayerTimeline.h"
 
 enum class DfInitProfile : uint8_t {
   Unknown = 0,
@@ -58,6 +118,115 @@ struct PlayerInitResult {
 
 using InitResultCallback = void (*)(const PlayerInitResult&, void* userCtx);
 
+// Outcome reported to a PlayerCommandCallback.
+enum class PlayerCommandStatus : uint8_t {
+  Sent,       // frame was written by sendCommand()
+  Merged,     // replaced by a newer value of the same opcode before it was sent
+  Superseded, // a queued play cancelled by a later stop or a newer play
+  Elided,     // removed by a peephole rule (made redundant by a later command)
+  Unchanged,  // not sent: the module already has this setting (shadow state)
+  Expired     // not sent: its deadline passed while it waited in the queue
+};
+
+// Module settings mirrored by the controller's shadow state. A setting command
+// whose value matches the last value actually written is never sent.
+enum class PlayerStateKey : uint8_t {
+  Volume = 0,
+  Eq,
+  Loop,
+  Device,
+  Count
+};
+
+// Peephole rule: when `second` is posted while `first` is still queued (with
+// no play queued in between), the queued `first` is dropped because `second`
+// makes it redundant. Backends return a static table from peepholeRules().
+struct PlayerPeepholeRule {
+  uint8_t first;
+  uint8_t second;
+};
+
+// Dispatch priority of a backend opcode; lower values are sent first.
+//  Urgent  - stop: overtakes everything and cancels queued plays
+//  Play    - play: everything queued before it is sent before it
+//  Control - loop mode, EQ, device selection
+//  Bulk    - volume (fade steps)
+enum class PlayerCommandClass : uint8_t {
+  Urgent = 0,
+  Play,
+  Control,
+  Bulk
+};
+
+// One resolved command in the trace ring (see PlayerController::dumpTrace()).
+// Written in O(1) with no I/O, so tracing does not disturb the pacing it
+// records. Times are millis().
+struct PlayerTraceRecord {
+  uint32_t postMs;       // when the command was posted
+  uint16_t sendDeltaMs;  // posted -> resolved (sent/merged/...), saturates at 0xFFFF
+  uint16_t gapMs;        // pacing gap applied after it (0 unless Sent)
+  uint16_t a;            // first argument as resolved
+  uint16_t b;            // second argument as resolved
+  uint8_t  type;         // backend opcode
+  uint8_t  status;       // PlayerCommandStatus
+  uint8_t  queueDepth;   // commands still queued afterwards
+};
+
+// Log2 latency histogram: bucket 0 counts 0 ms, bucket i counts
+// 2^(i-1) .. 2^i - 1 ms, the last bucket everything from 1024 ms up.
+// record() is O(1) and never allocates; bucket counters saturate.
+struct PlayerLatencyHistogram {
+  static const uint8_t BUCKETS = 12;
+  uint16_t bucket[BUCKETS] = {};
+  uint32_t count = 0;
+  uint32_t sumMs = 0;
+  uint16_t maxMs = 0;
+
+  static uint8_t bucketFor(uint32_t ms) {
+    if (ms == 0) return 0;
+    const uint8_t bits = (uint8_t)(32 - __builtin_clz(ms));
+    return bits < BUCKETS ? bits : BUCKETS - 1;
+  }
+  // Largest latency counted by bucket i (the last bucket is open-ended).
+  static uint32_t bucketUpperMs(uint8_t i) { return i == 0 ? 0 : (1UL << i) - 1; }
+
+  void record(uint32_t ms) {
+    uint16_t& b = bucket[bucketFor(ms)];
+    if (b != 0xFFFF) b++;
+    count++;
+    sumMs += ms;
+    if (ms > maxMs) maxMs = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+  }
+  uint32_t meanMs() const { return count ? sumMs / count : 0; }
+  // Upper bound of the bucket holding the pct-th percentile, capped at maxMs.
+  uint32_t percentileMs(uint8_t pct) const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < BUCKETS; ++i) total += bucket[i];
+    if (total == 0) return 0;
+    const uint32_t want = (total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKETS; ++i) {
+      seen += bucket[i];
+      if (seen >= want && seen != 0) {
+        return (i == BUCKETS - 1 || bucketUpperMs(i) > maxMs) ? maxMs : bucketUpperMs(i);
+      }
+    }
+    return maxMs;
+  }
+};
+
+using PlayerCommandCallback = void (*)(uint16_t ticket, PlayerCommandStatus status, void* userCtx);
+
+// Learned per-opcode command gaps, as produced by calibrateCommandGaps(). Plain
+// data so a sketch can persist it (Preferences/EEPROM) and restore it at boot
+// with importGapProfile(). gapMs[i] == 0 means "use the backend default".
+struct PlayerGapProfile {
+  static const uint32_t MAGIC = 0x47415031UL;  // "GAP1"
+  uint32_t magic = 0;
+  uint32_t playerTypeHash = 0;
+  uint16_t gapMs[PLAYER_MAX_OPCODES] = {};
+};
+
 class PlayerController {
 public:
   bool debug = false;
@@ -78,6 +247,9 @@ public:
       OUT
   };
 
+  // Volume-over-time shape of a fade (see PlayerFadeCurves.h).
+  using FadeCurve = PlayerFadeCurve;
+
 //| const             | value  |
 //| :---------------- | :----- |
 //| `DY::Eq::Normal`  | `0x00` |
@@ -148,30 +320,93 @@ public:
   virtual void setVolume(int volume);
   int getVolume();
 
-  virtual void fadeIn(int durationMs, int targetVolume, int playTrack, unsigned long trackDurationMs, const char* trackName);
-  virtual void fadeOut(int durationMs, int targetVolume, bool stopSound);
-  virtual void fadeTo(int durationMs,int targetVolume);
+  virtual void fadeIn(int durationMs, int targetVolume, int playTrack, unsigned long trackDurationMs, const char* trackName,
+                      FadeCurve curve = FadeCurve::LINEAR);
+  virtual void fadeOut(int durationMs, int targetVolume, bool stopSound, FadeCurve curve = FadeCurve::LINEAR);
+  virtual void fadeTo(int durationMs,int targetVolume, FadeCurve curve = FadeCurve::LINEAR);
   void stopFade(bool stopSound = false);
   bool isFading();
   bool isFadingIn();
   bool isFadingOut();
-
-  virtual void playSound(int track, unsigned long durationMs, const char* trackName);
-  virtual void playTrack(int track, unsigned long durationMs, const char* trackName);
-
-  // Deferred/scheduled play (generic syncPlaySound support). countdownMs is
-  // measured from the call. volume < 0 => leave current volume unchanged. The
-  // resolved durationMs/trackName are supplied by the caller (sketch resolves
-  // them via SoundLibrary); trackName must point to static/flash storage.
-  // Fires from update(); cancelled by any stop()/stopSound (stopSoundSetStatus).
-  void schedulePlay(int track, unsigned long durationMs, const char* trackName,
-                    int volume, uint32_t countdownMs);
-  void cancelScheduledPlay();
-  bool hasScheduledPlay() const { return _syncPlayPending; }
-
+  // fadeIn/fadeOut/fadeTo called while a fade runs retarget it: the new fade
+  // starts from the current volume and ends durationMs from the call.
+  uint32_t getFadeRetargetCount() const { return _fadeRetargets; }
+
+  virtual void playSound(int track, unsigned long durationMs, const char* trackName) = 0;
+  virtual void playTrack(int track, unsigned long durationMs, const char* trackName) = 0;
+
+  // Scheduled actions (generic syncPlaySound support, show cue lists). Each
+  // call adds an entry to a timeline of PLAYER_TIMELINE_SIZE actions that
+  // update() fires in time order; countdownMs is measured from the call and
+  // actions due at the same ms fire in the order they were scheduled. Returns
+  // a handle for cancelScheduled(), or 0 when the timeline is full.
+  //
+  // schedulePlay: volume < 0 => leave current volume unchanged. The play
+  // fires getPlayStartLatencyMs() early (see calibratePlayStartLatency()), so
+  // the sound, not the command, starts at the scheduled time. The resolved
+  // durationMs/trackName are supplied by the caller (sketch resolves them via
+  // SoundLibrary); trackName must point to static/flash storage. A stop()
+  // called by the sketch cancels all scheduled plays; a scheduled stop, a
+  // sound reaching its end and the other actions leave them in place.
+  //
+  // preRoll: start the track muted getPreRollMs() early and restore the
+  // volume at the scheduled time, so a slow, variable file open becomes one
+  // fast volume command. The first getPreRollMs() of the track are not heard
+  // (the duration is extended to match). The handle covers the muted start;
+  // hasScheduledPlay() stays true until the volume is restored, and a stop()
+  // or clearSchedule() in between restores it. Backends without a pre-roll
+  // (getPreRollMs() == 0) play as without it.
+  typedef uint16_t ScheduleHandle;
+  ScheduleHandle schedulePlay(int track, unsigned long durationMs, const char* trackName,
+                              int volume, uint32_t countdownMs, bool preRoll = false);
+  ScheduleHandle scheduleStop(uint32_t countdownMs);
+  ScheduleHandle scheduleFadeTo(int durationMs, int targetVolume, uint32_t countdownMs,
+                                FadeCurve curve = FadeCurve::LINEAR);
+  ScheduleHandle scheduleVolume(int volume, uint32_t countdownMs);
+  ScheduleHandle scheduleEqualizerPreset(EqualizerPreset preset, uint32_t countdownMs);
+  bool cancelScheduled(ScheduleHandle handle);
+  bool isScheduled(ScheduleHandle handle) const { return _timeline.contains(handle); }
+  void cancelScheduledPlay();  // all scheduled plays
+  void clearSchedule();        // everything
+  bool hasScheduledPlay() const;
+  uint8_t getScheduledCount() const { return _timeline.size(); }
+
+  // Gapless follow-up: the next track starts when the current one ends,
+  // without waiting for the sketch to poll isSoundPlaying(). With a duration
+  // the play goes out leadMs before it runs out (-1 = getPlayStartLatencyMs(),
+  // so the new sound starts on time). Backends that can chain files themselves
+  // (AK) switch at the end of the file, without a gap. One track can wait; a
+  // new call replaces it, nothing playing plays it now. A stop() by the sketch
+  // drops it. trackName must point to static/flash storage. Returns false when
+  // the current track has no duration and the backend does not report the end
+  // of a track (see reportsEndOfTrack()): the follow-up could never start.
+  bool queueNextTrack(int track, unsigned long durationMs, const char* trackName, int leadMs = -1);
+  bool hasQueuedNextTrack() const { return _next.queued; }
+  void clearQueuedNextTrack();
+  // true = the backend notices by itself when a file ends (AK). DF, DY, MD and
+  // XY do not: there a track only ends after the duration given to playTrack().
+  virtual bool reportsEndOfTrack() const { return false; }
+
+  // Volume envelopes (PlayerEnvelope.h), played back from update(). NOW starts
+  // immediately; ON_PLAY starts with the next playTrack() (direct or fired by
+  // schedulePlay), once its play frame is on the wire. An envelope replaces
+  // any running fade, and a fade or stop() ends the envelope. The envelope is
+  // referenced, not copied.
+  enum class EnvelopeStart : uint8_t { NOW, ON_PLAY };
+  void startEnvelope(const PlayerEnvelope& envelope, EnvelopeStart when = EnvelopeStart::NOW);
+  void stopEnvelope();
+  bool isEnvelopeActive() const { return _envelope != nullptr; }
+
+  // Status after a backend queued its play: playTicket is what
+  // submitPlayerCommandBase() returned for it, and 0 (not queued) leaves the
+  // status alone. The ON_PLAY envelope and fadeIn() wait for that ticket. The
+  // three-argument form is for a track that starts without a play command (NO
+  // player, a file the backend chained itself).
   virtual void playSoundSetStatus(int track, unsigned long durationMs, const char* trackName);
-  virtual void stopSoundSetStatus();
-  virtual void stop();
+  void playSoundSetStatus(int track, unsigned long durationMs, const char* trackName, uint16_t playTicket);
+  // endOfTrack: the sound ran out by itself (keeps scheduled plays)
+  virtual void stopSoundSetStatus(bool endOfTrack = false);
+  virtual void stop() = 0;
 
   virtual void enableLoop() = 0;
   virtual void disableLoop() = 0;
@@ -183,8 +418,25 @@ public:
   void displayVolumeProgressBar();
   void displayEqualizerSettings();
 
-  //    void playSoundRandom(int minTrack, int maxTrack);
-  void update();
+  // Plays a random track from minTrack..maxTrack, never the one it picked
+  // last time (PlayerPlaylist for shuffle, weights and per-track durations).
+  // durationMs and trackName apply to whichever track is drawn.
+  void playSoundRandom(int minTrack, int maxTrack, unsigned long durationMs = 0, const char* trackName = "random");
+  virtual void update();
+
+  // Optional service task: runs update() on its own FreeRTOS task (ESP32) or
+  // std::thread (host) every tickMs, so fades, durations, scheduled plays and
+  // command pacing no longer depend on loop() latency. While it runs, the
+  // public API is serialised by a recursive mutex and command callbacks fire
+  // from the service task. Do not also call update() from loop() (harmless,
+  // but pointless). Returns false where no threading backend exists.
+  // stopServiceTask() may be called from the task itself (a command callback):
+  // the task then ends after the current update(). Backends stop it in their
+  // destructor, before the members update() uses are gone.
+  bool startServiceTask(uint16_t tickMs = 5, uint8_t priority = 2, int8_t core = -1);
+  void stopServiceTask() { _serviceTask.stop(); }
+  virtual ~PlayerController() { stopServiceTask(); }
+  bool isServiceTaskRunning() const { return _serviceTask.isRunning(); }
   bool isSoundPlaying() const { return playerStatus == STATUS_PLAYING; }
   int getCurrentTrack() const { return currentTrack; }
   // Returns elapsed playback time in ms (0 when not playing); capped at duration.
@@ -197,15 +449,120 @@ public:
   unsigned long getPlayDurationMs() const { return playDuration; }
   const char* createProgressBar(int value, int maxLength);
 
-  inline void executePlayerCommandBase(uint8_t type, uint16_t a = 0, uint16_t b = 0) {
-    // last-wins pending slot
-    _pendingType = type;
-    _pendingA    = a;
-    _pendingB    = b;
-    // No logging or flushing here (ISR-safe). Actual send happens in update().
+  // Ordered command queue. Commands are sent from update(), one per pacing gap
+  // (normalGapMs()/afterPlayGapMs()), most urgent class first (see
+  // PlayerCommandClass), oldest first within a class. Coalescable opcodes
+  // (volume) replace the newest queued entry of the same type instead of taking
+  // a new slot. Returns false (and counts a drop) when the queue or the opcode's
+  // class is full. No logging or flushing here. Not ISR/cross-core safe: from
+  // ISRs, other tasks or the other core use postPlayerCommandFromIsr().
+  bool executePlayerCommandBase(uint8_t type, uint16_t a = 0, uint16_t b = 0);
+
+  // Lock-free post for GPIO ISRs, network tasks and the other ESP32 core. The
+  // command lands in a mailbox that update() moves into the ordered queue.
+  // Returns false when the mailbox is full.
+  bool postPlayerCommandFromIsr(uint8_t type, uint16_t a = 0, uint16_t b = 0) {
+    return _mailbox.post(type, a, b);
+  }
+
+  // Asynchronous submission. Queues like executePlayerCommandBase and returns
+  // immediately with a ticket (0 = queue full). cb (optional) fires from update()
+  // once the frame has gone out on the wire, or with Merged if a newer value of
+  // the same opcode replaced it. Poll with isCommandPending(ticket) instead.
+  // Outcomes decided in the caller's context (Merged, Superseded, Elided,
+  // Unchanged at post time) are held and delivered by the next update(); only
+  // when more than PLAYER_CALLBACK_QUEUE_SIZE pile up between two update()
+  // calls does the overflow fire in place, inside the posting call.
+  uint16_t submitPlayerCommandBase(uint8_t type, uint16_t a = 0, uint16_t b = 0,
+                                   PlayerCommandCallback cb = nullptr, void* userCtx = nullptr);
+  bool     isCommandPending(uint16_t ticket) const;
+
+  // Deadline-aware variants: the command is only worth sending within
+  // validForMs of being posted. One that is still queued after its deadline is
+  // refreshed to the current desired state (refreshExpiredCommand(), e.g. the
+  // fade's current volume) or dropped with Expired; it never replays stale
+  // history. validForMs == 0 means no deadline.
+  bool     executePlayerCommandUntilBase(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs);
+  uint16_t submitPlayerCommandUntilBase(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs,
+                                        PlayerCommandCallback cb = nullptr, void* userCtx = nullptr);
+  uint16_t getLastSubmittedTicket() const { return _lastTicket; }
+
+  uint8_t  getPendingCommandCount() const { return _queueCount; }
+  uint32_t getDroppedCommandCount() const { return _cmdDropped; }
+  uint32_t getMergedCommandCount()  const { return _cmdMerged; }
+  uint32_t getElidedCommandCount()  const { return _cmdElided; }
+  uint32_t getUnchangedCommandCount() const { return _cmdUnchanged; }
+  // Deadline misses: high counts mean the UART link is the bottleneck.
+  uint32_t getExpiredCommandCount()   const { return _cmdExpired; }
+  uint32_t getRefreshedCommandCount() const { return _cmdRefreshed; }
+  void     resetCommandCounters() {
+    _cmdDropped = 0; _cmdMerged = 0; _cmdElided = 0; _cmdUnchanged = 0;
+    _cmdExpired = 0; _cmdRefreshed = 0;
   }
 
+  // Command trace: the last PLAYER_TRACE_SIZE resolved commands. dumpTrace()
+  // prints them oldest first as one hex line each (decode on a PC with
+  // extras/trace_decode.py); it is the only part that does I/O.
+  uint8_t getTraceCount() const { return _traceCount; }
+  bool    getTraceRecord(uint8_t i, PlayerTraceRecord& out) const;  // 0 = oldest
+  void    clearTrace() { _traceCount = 0; _traceOverwritten = 0; }
+  void    dumpTrace(Print& out, bool clear = true);
+
+  // Per-opcode latency histograms (PLAYER_LATENCY_HISTOGRAMS). Post-to-wire:
+  // from posting a command to sendCommand() writing it. Wire-to-status: from
+  // the write to the module confirming it (ACK, query answer, first decoded
+  // audio); only filled by backends with a feedback path. nullptr for an
+  // out-of-range opcode or when histograms are compiled out.
+  const PlayerLatencyHistogram* getPostToWireHistogram(uint8_t type) const;
+  const PlayerLatencyHistogram* getWireToStatusHistogram(uint8_t type) const;
+  void resetLatencyHistograms();
+  void printLatencyHistograms(Print& out) const;
+
+  // Shadow state: the last value written for each PlayerStateKey, updated only
+  // when sendCommand() actually puts a setting on the wire. Setting commands
+  // that would not change it are skipped (counted as Unchanged), both when
+  // posted and when dispatched. Unknown after boot; call
+  // invalidateShadowState() after anything that may reset the module behind
+  // the controller's back (power cycle, direct library calls).
+  bool getShadowState(PlayerStateKey key, uint16_t& value) const;
+  void invalidateShadowState() { _shadowKnown = 0; }
+
+  // Adaptive command gaps. calibrateCommandGaps() measures how long the module
+  // takes to accept each of the backend's calibration commands (via its RX/ACK
+  // path, see probeCommandLatency()) and learns a per-opcode gap with a safety
+  // margin. Blocking and audible when testTrack > 0 (plays it briefly): run it
+  // from setup(). Learned gaps only apply while adaptive gaps are enabled;
+  // returns false when the backend has no feedback path.
+  bool calibrateCommandGaps(int testTrack = 0, uint8_t rounds = 3);
+  void setAdaptiveGapsEnabled(bool enabled) { _adaptiveGaps = enabled; }
+  bool isAdaptiveGapsEnabled() const { return _adaptiveGaps; }
+  uint16_t getLearnedGapMs(uint8_t type) const { return type < PLAYER_MAX_OPCODES ? _learnedGapMs[type] : 0; }
+  void exportGapProfile(PlayerGapProfile& profile) const;
+  bool importGapProfile(const PlayerGapProfile& profile);
+  void clearLearnedGaps();
+
+  // Play-start latency: time from a play being dispatched to audio at the
+  // speaker. Every backend has a typical value; calibratePlayStartLatency()
+  // measures the attached module instead, through its BUSY pin (setBusyPin())
+  // or, without one, its status query. It plays testTrack `rounds` times and
+  // keeps the median (blocking and audible: run it from setup()). Scheduled
+  // plays fire this much early, so audible starts line up across module types.
+  bool calibratePlayStartLatency(int testTrack, uint8_t rounds = 3);
+  void setBusyPin(int8_t pin, bool activeLow = true);
+  uint16_t getPlayStartLatencyMs() const;
+  void setPlayStartLatencyMs(uint16_t ms) { _playStartLatencyMs = ms; }  // e.g. a stored calibration
+  void clearPlayStartLatency() { _playStartLatencyMs = PLAY_START_LATENCY_UNSET; }
+  void setPlayStartCompensationEnabled(bool enabled) { _playStartCompensation = enabled; }
+  bool isPlayStartCompensationEnabled() const { return _playStartCompensation; }
+  // Muted lead for schedulePlay(..., preRoll = true); 0 = no pre-roll. Should
+  // exceed the play-start latency so the file is open when the volume returns.
+  uint16_t getPreRollMs() const { return _preRollMs != PLAY_START_LATENCY_UNSET ? _preRollMs : preRollMs(); }
+  void setPreRollMs(uint16_t ms) { _preRollMs = ms; }
+  void clearPreRoll() { _preRollMs = PLAY_START_LATENCY_UNSET; }
+
   void flushPendingIfReadyBase_();
+  // Blocking send: drains the queue and spins until the pacing gap has passed.
+  // Only for setup paths; runtime commands should use submitPlayerCommandBase.
   void executePlayerCommandNowBase(uint8_t type, uint16_t a = 0, uint16_t b = 0);
 
 protected:
@@ -225,11 +582,19 @@ protected:
     // Volume-related variables
     int currentVolume;
     int targetVolume;
-    int volumeStep;
 
     void decodeFolderAndTrack(uint16_t trackNumber, uint8_t& folder, uint8_t& track);
     static const int DEFAULT_FADE_INTERVAL_MS = 80;
-    int fadeIntervalMs = DEFAULT_FADE_INTERVAL_MS;
+    static const int MIN_FADE_TICK_MS = 10;
+    // Time-based fade: the volume at step k of fadeSteps is interpolated
+    // between fadeStartVolume and targetVolume along fadeCurve; step k is due
+    // at fadeStartTime + k * fadeDurationMs / fadeSteps (see beginFade_()).
+    int fadeIntervalMs = DEFAULT_FADE_INTERVAL_MS;  // fadeDurationMs / fadeSteps
+    int fadeStartVolume = 0;
+    unsigned long fadeDurationMs = 0;
+    uint8_t fadeSteps = 0;
+    uint8_t fadeStepsDone = 0;
+    FadeCurve fadeCurve = FadeCurve::LINEAR;
     bool shouldStopAfterFade = false;
 
     // Derived classes must provide these:
@@ -237,10 +602,91 @@ protected:
     virtual bool     isPlayCommand(uint8_t type) const { return false; }
     virtual uint16_t normalGapMs()    const = 0;
     virtual uint16_t afterPlayGapMs() const { return normalGapMs(); }
+    // Opcodes where only the newest value matters (volume): a new post replaces
+    // the queued one as long as no play command was queued after it.
+    virtual bool     isCoalescableCommand(uint8_t type) const { return false; }
+    // Gap to wait after sending `type`: the learned gap when adaptive gaps are
+    // enabled and calibrated, else afterPlayGapMs()/normalGapMs().
+    uint16_t commandGapMs(uint8_t type) const;
+
+    // Calibration hooks. calibrationCommands() fills `out` with the commands to
+    // measure (testTrack > 0 allows a play/stop pair) and returns the count.
+    // probeCommandLatency() sends one command, waits for the module to confirm
+    // it (ACK or query response) and reports the elapsed time; false = no
+    // feedback (no RX wired, timeout) or not supported by the backend.
+    struct CalibrationCommand {
+      uint8_t  type;
+      uint16_t a;
+      uint16_t b;
+    };
+    virtual uint8_t calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const { return 0; }
+    virtual bool    probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) { return false; }
+
+    // Typical time from dispatching a play to audio at the speaker (frame
+    // transfer plus module start-up), used until calibratePlayStartLatency()
+    // has measured the real module.
+    virtual uint16_t playStartLatencyMs() const { return 0; }
+    // Sends a play for testTrack outside the queue and waits until the module
+    // reports that it is playing; false = no feedback. The caller stops it.
+    virtual bool probePlayStart(int testTrack, uint16_t& elapsedMs) { return false; }
+    // Default muted lead for pre-rolled scheduled plays. Longer hides more of
+    // the start-up jitter but cuts more of the track's beginning; 0 where the
+    // module starts fast and evenly enough without it.
+    virtual uint16_t preRollMs() const { return 0; }
+
+    // queueNextTrack() hand-off: true = the backend prepared the track and
+    // switches to it at the end of the current file itself, then calls
+    // nextTrackChained(). disarmNextTrack() releases what armNextTrack() took.
+    virtual bool armNextTrack(int track) { return false; }
+    virtual void disarmNextTrack() {}
+    void nextTrackChained();
+
+    // Per-backend peephole rules applied when a command is queued (see
+    // PlayerPeepholeRule). Returns the table and sets count; none by default.
+    virtual const PlayerPeepholeRule* peepholeRules(uint8_t& count) const { count = 0; return nullptr; }
+
+    // Priority class of an opcode (see PlayerCommandClass).
+    virtual PlayerCommandClass commandClass(uint8_t type) const {
+      return isPlayCommand(type) ? PlayerCommandClass::Play : PlayerCommandClass::Control;
+    }
+
+    // Shadow-state mapping: the module setting `type` writes and its value.
+    // Return false for commands without a persistent setting (play, stop).
+    virtual bool commandStateEffect(uint8_t type, uint16_t a, uint16_t b,
+                                    PlayerStateKey& key, uint16_t& value) const { return false; }
+    // Called for a queued command whose deadline passed. Rewrite a/b to the
+    // current desired state and return true to send that instead, or return
+    // false to drop it. Default: volume is refreshed to currentVolume (all
+    // backends encode volume as a = 0..30), everything else is dropped.
+    virtual bool refreshExpiredCommand(uint8_t type, uint16_t& a, uint16_t& b) const;
+    // Fade offload: a backend that can ramp the gain in its own audio path
+    // starts a ramp from its current output level to targetVolume over
+    // durationMs along curve (normally by queueing a ramp opcode) and returns
+    // true. The base then sends no intermediate volumes, only tracks
+    // currentVolume along the same curve, and calls setVolume() with the
+    // reached volume when the fade is stopped early. Return false when the
+    // ramp could not be queued; the base steps the fade instead. Default: not
+    // supported.
+    virtual bool beginHardwareFade(int targetVolume, uint32_t durationMs, FadeCurve curve) { return false; }
+
+    // Backends report how long the module took to confirm a written command.
+    void noteWireToStatusLatency(uint8_t type, uint32_t ms);
+
+    // Records a setting written outside the queue (begin() sequences).
+    void noteShadowState(PlayerStateKey key, uint16_t value);
+    // Marks one setting unknown, e.g. from sendCommand() for a command that
+    // only reaches its value later (a gain ramp); note it once it has.
+    void forgetShadowState(PlayerStateKey key);
+
+    bool hasPendingCommand(uint8_t type) const;
 
     // Pretty name for debug (derived overrides)
     virtual const char* cmdName(uint8_t type) const { return "?"; }
 
+    // Held by the public API while the service task runs (no-op otherwise).
+    // Derived classes can take it to make multi-step operations atomic.
+    mutable PlayerRecursiveMutex _apiMutex;
+
     void emitInitResult(const PlayerInitResult& result) {
       lastInitResult = result;
       hasInitResult = true;
@@ -267,21 +713,156 @@ private:
   uint32_t _dbgNextLogMs{ 0 };
   static constexpr uint16_t DBG_POST_EVERY_MS = 80;
 
-  // pending slot (last-wins)
-  uint8_t  _pendingType { 0 };
-  uint16_t _pendingA    { 0 };
-  uint16_t _pendingB    { 0 };
+  // ordered command queue (ring buffer, oldest at _queueHead)
+  struct PendingCommand {
+    uint8_t               type;
+    PlayerCommandClass    cls;     // effective class (may be promoted by a later play)
+    uint16_t              a;
+    uint16_t              b;
+    uint16_t              ticket;
+    uint32_t              postMs;
+    bool                  hasDeadline;
+    uint32_t              validUntilMs;
+    PlayerCommandCallback cb;
+    void*                 cbCtx;
+  };
+  PendingCommand _queue[PLAYER_CMD_QUEUE_SIZE] {};
+  uint16_t _lastTicket { 0 };
+  uint8_t  _queueHead  { 0 };
+  uint8_t  _queueCount { 0 };
+  uint32_t _cmdDropped { 0 };
+  uint32_t _cmdMerged  { 0 };
+  uint32_t _cmdElided  { 0 };
+  uint32_t _cmdUnchanged { 0 };
+  uint32_t _cmdExpired   { 0 };
+  uint32_t _cmdRefreshed { 0 };
+  // Deadline applied to posts that do not pass one (set around fade steps).
+  uint16_t _postValidForMs { 0 };
+  // Every queued command ends here exactly once: trace, then callback.
+  void     finish_(const PendingCommand& cmd, PlayerCommandStatus status, uint16_t gapMs = 0);
+
+  // Callbacks raised outside update(), delivered by deliverCallbacks_().
+  struct PendingCallback {
+    PlayerCommandCallback cb;
+    void*                 cbCtx;
+    uint16_t              ticket;
+    PlayerCommandStatus   status;
+  };
+  PendingCallback _callbacks[PLAYER_CALLBACK_QUEUE_SIZE] {};
+  uint8_t  _callbackCount { 0 };
+  bool     _inUpdate { false };
+  void     deliverCallbacks_();
+
+  // trace ring (oldest at _traceHead)
+  static constexpr uint8_t TRACE_CAPACITY = PLAYER_TRACE_SIZE > 0 ? PLAYER_TRACE_SIZE : 1;
+  PlayerTraceRecord _trace[TRACE_CAPACITY] {};
+  uint8_t  _traceHead        { 0 };
+  uint8_t  _traceCount       { 0 };
+  uint32_t _traceOverwritten { 0 };
+  void     traceRecord_(const PendingCommand& cmd, PlayerCommandStatus status, uint16_t gapMs);
+
+#if PLAYER_LATENCY_HISTOGRAMS
+  PlayerLatencyHistogram _postToWire[PLAYER_MAX_OPCODES];
+  PlayerLatencyHistogram _wireToStatus[PLAYER_MAX_OPCODES];
+#endif
+
+  uint16_t submitCommand_(uint8_t type, uint16_t a, uint16_t b, uint16_t validForMs,
+                          PlayerCommandCallback cb, void* userCtx);
+
+  // shadow state (bit i of _shadowKnown => _shadowValue[i] is valid)
+  uint16_t _shadowValue[(uint8_t)PlayerStateKey::Count] {};
+  uint8_t  _shadowKnown { 0 };
+  bool     isUnchanged_(uint8_t type, uint16_t a, uint16_t b, bool alsoQueued = false) const;
+  bool     hasPendingState_(PlayerStateKey key) const;
+  void     sendTracked_(uint8_t type, uint16_t a, uint16_t b);
+
+  PendingCommand&       queueAt_(uint8_t i)       { return _queue[(_queueHead + i) % PLAYER_CMD_QUEUE_SIZE]; }
+  const PendingCommand& queueAt_(uint8_t i) const { return _queue[(_queueHead + i) % PLAYER_CMD_QUEUE_SIZE]; }
+  PlayerCommandMailbox<PLAYER_CMD_MAILBOX_SIZE, PLAYER_CMD_MAILBOX_MULTI_PRODUCER> _mailbox;
+  void drainMailbox_();
+
+  uint16_t nextTicket_() { if (++_lastTicket == 0) _lastTicket = 1; return _lastTicket; }
+  void     removeQueued_(uint8_t i);
+  void     applyPeepholeRules_(uint8_t type);
+  void     recoalesceQueued_();
+  void     mergeInto_(PendingCommand& cmd, uint16_t a, uint16_t b, uint32_t now,
+                      bool hasDeadline, uint32_t validUntilMs, PlayerCommandCallback cb, void* userCtx);
+  uint8_t  countQueuedInClass_(PlayerCommandClass cls) const;
+  static uint8_t classDepth_(PlayerCommandClass cls);
+
+  PlayerServiceTask _serviceTask;
+  static void serviceTick_(void* ctx) { static_cast<PlayerController*>(ctx)->update(); }
 
   // spacing
   uint32_t _nextReadyMs { 0 };
+  bool     _adaptiveGaps { false };
+  uint16_t _learnedGapMs[PLAYER_MAX_OPCODES] {};
+  uint32_t playerTypeHash_() const;
+
+  // Scheduled actions (schedulePlay() & co.), fired from update()
+  // PreRollPlay starts a play muted and schedules its Unmute (volume = the
+  // level to restore); both count as a scheduled play.
+  enum class ScheduledActionType : uint8_t { Play, Stop, FadeTo, SetVolume, SetEqualizerPreset, PreRollPlay, Unmute };
+  struct ScheduledAction {
+    ScheduledActionType type { ScheduledActionType::Play };
+    int8_t        volume     { -1 };       // play: -1 => leave current; fade/volume target
+    uint8_t       arg        { 0 };        // fade curve, EQ preset
+    uint16_t      preRollMs  { 0 };        // pre-roll play: muted lead
+    int           track      { 0 };
+    unsigned long durationMs { 0 };        // play: track duration; fade: fade time
+    const char*   trackName  { nullptr };  // static/flash pointer (SoundLibrary)
+  };
+  PlayerTimeline<ScheduledAction, PLAYER_TIMELINE_SIZE> _timeline;
+  bool _firingScheduled { false };  // a fired stop must not cancel the rest of the timeline
 
-  // deferred/scheduled play slot (syncPlaySound) — resolved values stored here
-  bool          _syncPlayPending  { false };
-  int           _syncPlayTrack    { -1 };
-  unsigned long _syncPlayDuration { 0 };
-  const char*   _syncPlayName     { nullptr };  // static/flash pointer (SoundLibrary)
-  int           _syncPlayVolume   { -1 };       // -1 => leave current volume
-  uint32_t      _syncPlayFireAtMs { 0 };
+  ScheduleHandle scheduleAction_(const ScheduledAction& action, uint32_t countdownMs);
+  void fireScheduled_(const ScheduledAction& action, uint32_t fireAtMs);
+  static bool isScheduledPlay_(ScheduledActionType type) {
+    return type == ScheduledActionType::Play || type == ScheduledActionType::PreRollPlay || type == ScheduledActionType::Unmute;
+  }
+  void restorePreRollVolume_();
+
+  // fadeIn() waiting for its play command to reach the wire (0 = none). The
+  // fade is IN but its ramp only starts once this ticket has resolved.
+  uint16_t      _fadeInPlayTicket { 0 };
+  uint16_t      _playTicket { 0 };         // play command behind the current status, 0 = none
+  uint32_t      _fadeRetargets { 0 };
+  bool          _hardwareFade { false };   // running fade is ramped by the backend (beginHardwareFade)
+
+  // Play-start latency compensation (calibratePlayStartLatency())
+  static const uint16_t PLAY_START_LATENCY_UNSET = 0xFFFF;
+  uint16_t      _playStartLatencyMs { PLAY_START_LATENCY_UNSET };  // calibrated/set, else the backend's typical value
+  bool          _playStartCompensation { true };
+  int8_t        _busyPin { -1 };
+  bool          _busyActiveLow { true };
+  uint16_t      _preRollMs { PLAY_START_LATENCY_UNSET };  // set, else the backend's preRollMs()
+
+  // queueNextTrack() slot
+  struct NextTrack {
+    bool          queued     { false };
+    bool          chained    { false };    // the backend switches itself (armNextTrack())
+    int           track      { 0 };
+    unsigned long durationMs { 0 };
+    const char*   trackName  { nullptr };  // static/flash pointer
+    uint16_t      leadMs     { 0 };
+  };
+  NextTrack     _next;
+  int           _lastRandomTrack { 0 };  // playSoundRandom()
+  void playQueuedNextTrack_();
+  bool probePlayStartBusy_(int testTrack, uint16_t& elapsedMs);
+
+  // Envelope playback (startEnvelope()). Armed: waiting for the next play.
+  // _envelopeStartTicket: started, waiting for that play to reach the wire.
+  const PlayerEnvelope* _envelope { nullptr };
+  bool          _envelopeArmed { false };
+  uint16_t      _envelopeStartTicket { 0 };
+  uint32_t      _envelopeStartMs { 0 };
+  uint32_t      _envelopeLastSendMs { 0 };
+  int           _envelopeStartVolume { 0 };
+  uint8_t       _envelopeCursor { 0 };
+  void startEnvelopeNow_(uint16_t waitForTicket);
+  void setPlayStatus_(int track, unsigned long durationMs, const char* trackName, uint16_t playTicket);
+  void updateEnvelope_(uint32_t now);
 
   // debug helpers (declared; defined in .cpp)
   void debugPost_(uint8_t type, uint16_t a, uint16_t b, uint32_t now);
@@ -289,6 +870,10 @@ private:
 
 
     const char* fadeDirectionToString(FadeDirection direction);
+    void beginFade_(FadeDirection direction, int durationMs, FadeCurve curve);
+    int  fadeVolumeAt_(uint8_t step) const;
+    bool retargetFade_(int durationMs, FadeCurve curve);
+    void noteFadeRetarget_(const char* caller);
     unsigned long fadeStartTime;
     int currentTrack;
     const char* currentTrackName;
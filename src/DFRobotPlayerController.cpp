@@ -59,6 +59,7 @@ void DFRobotPlayerController::beginFastTxOnly() {
   Serial.println(F("DFPlayer Mini online (fast TX-only)."));
   delay(20);
   myDFPlayer.outputDevice(DFPLAYER_DEVICE_SD);
+  noteShadowState(PlayerStateKey::Device, DFPLAYER_DEVICE_SD);
   delay(DF_CMD_GAP_MS);
   initResult.success = true;
   emitInitResult(initResult);
@@ -274,6 +275,7 @@ void DFRobotPlayerController::begin() {
   delay(DF_CMD_GAP_MS);
   // (optional but often helpful)
   myDFPlayer.outputDevice(DFPLAYER_DEVICE_SD);
+  noteShadowState(PlayerStateKey::Device, DFPLAYER_DEVICE_SD);
   delay(DF_CMD_GAP_MS);
   myDFPlayer.setTimeOut(1000);
   delay(DF_CMD_GAP_MS);
@@ -284,6 +286,7 @@ void DFRobotPlayerController::begin() {
 }
 
 void DFRobotPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+    PlayerLockGuard lock(_apiMutex);
     int _folder = ((track - 1) / 255) + 1;
     int _track = ((track - 1) % 255) + 1;
 
@@ -294,9 +297,9 @@ void DFRobotPlayerController::playTrack(int track, unsigned long durationMs, con
     Serial.printf("  ▶️ %s - track: %u (Dec) '%s', duration: %lu ms\n", "DFRobotPlayerController::playTrack", track, trackName, durationMs);
 
     // myDFPlayer.playFolder(_folder, _track);
-    executePlayerCommandNowBase(DFCmd_PlayTrack, (uint16_t)track);
+    const uint16_t ticket = submitPlayerCommandBase(DFCmd_PlayTrack, (uint16_t)track);
     // Call the base class for status, duration and trackName
-    PlayerController::playSoundSetStatus(track, durationMs, trackName);
+    PlayerController::playSoundSetStatus(track, durationMs, trackName, ticket);
 }
 
 void DFRobotPlayerController::playSound(int track, unsigned long durationMs, const char* trackName) {
@@ -305,10 +308,11 @@ void DFRobotPlayerController::playSound(int track, unsigned long durationMs, con
 }
 
 void DFRobotPlayerController::stop() {
+    PlayerLockGuard lock(_apiMutex);
     Serial.printf("  ⏹️ %s - Stopping sound\n", __PRETTY_FUNCTION__);
     Serial.printf("      %s - myDFPlayer.stop()\n", __PRETTY_FUNCTION__);
 
-    executePlayerCommandNowBase(DFCmd_Stop);
+    if (submitPlayerCommandBase(DFCmd_Stop) == 0) return;  // not queued: still playing
     // myDFPlayer.stop();
 
     // Call base class for status
@@ -316,8 +320,7 @@ void DFRobotPlayerController::stop() {
 }
 
 void DFRobotPlayerController::setPlayerVolume(uint8_t v) {
-  if (v == lastSetPlayerVolume) return;
-  executePlayerCommandNowBase(DFCmd_Volume, v);
+  executePlayerCommandBase(DFCmd_Volume, v);  // skipped by the base if unchanged
 //    if (_playerVolume != lastSetPlayerVolume) {
 //      executePlayerCommandBase(DFCmd_Volume, _playerVolume);
 //        // myDFPlayer.volume(_playerVolume);
@@ -329,8 +332,8 @@ void DFRobotPlayerController::setPlayerVolume(uint8_t v) {
     // delay(DF_CMD_GAP_MS);
 }
 
-void DFRobotPlayerController::enableLoop()  { executePlayerCommandBase(DFCmd_LoopOn);  isLooping = true;  }
-void DFRobotPlayerController::disableLoop() { executePlayerCommandBase(DFCmd_LoopOff); isLooping = false; }
+void DFRobotPlayerController::enableLoop()  { PlayerLockGuard lock(_apiMutex); executePlayerCommandBase(DFCmd_LoopOn);  isLooping = true;  }
+void DFRobotPlayerController::disableLoop() { PlayerLockGuard lock(_apiMutex); executePlayerCommandBase(DFCmd_LoopOff); isLooping = false; }
 
 //void DFRobotPlayerController::enableLoop() {
 //    delay(DF_CMD_GAP_MS);
@@ -341,6 +344,7 @@ void DFRobotPlayerController::disableLoop() { executePlayerCommandBase(DFCmd_Loo
 //}
 
 void DFRobotPlayerController::setEqualizerPreset(EqualizerPreset preset) {
+  PlayerLockGuard lock(_apiMutex);
   uint8_t eq = DFPLAYER_EQ_NORMAL;
   switch (preset) {
     case EqualizerPreset::POP:     eq = DFPLAYER_EQ_POP;     break;
@@ -350,7 +354,7 @@ void DFRobotPlayerController::setEqualizerPreset(EqualizerPreset preset) {
     case EqualizerPreset::BASS:    eq = DFPLAYER_EQ_BASS;    break;
     default:                       eq = DFPLAYER_EQ_NORMAL;  break;
   }
-  executePlayerCommandNowBase(DFCmd_Eq, eq);
+  executePlayerCommandBase(DFCmd_Eq, eq);
   PlayerController::setEqualizerPreset(preset);
 }
 
@@ -391,13 +395,65 @@ void DFRobotPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t b)
     case DFCmd_Volume:
       Serial.print(F("volume(")); Serial.print((uint8_t)a); Serial.println(')');
       myDFPlayer.volume((uint8_t)a);
-      lastSetPlayerVolume = (int8_t)constrain((int)a, (int)MIN_VOLUME, (int)MAX_VOLUME);
       break;
     case DFCmd_Eq:        Serial.print(F("EQ(")); Serial.print((uint8_t)a); Serial.println(')');     myDFPlayer.EQ((uint8_t)a);     break;
     default:              Serial.println(F("UNKNOWN")); break;
   }
 }
 
+uint8_t DFRobotPlayerController::calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const {
+  if (serialRxPin < 0) return 0;  // TX-only wiring: no feedback path
+  uint8_t n = 0;
+  uint16_t vol = MIN_VOLUME;
+  getShadowState(PlayerStateKey::Volume, vol);
+  if (n < max) out[n++] = { DFCmd_Volume, vol, 0 };
+  if (n < max) out[n++] = { DFCmd_Eq, DFPLAYER_EQ_NORMAL, 0 };
+  if (testTrack > 0 && n + 1 < max) {
+    out[n++] = { DFCmd_PlayTrack, (uint16_t)testTrack, 0 };
+    out[n++] = { DFCmd_Stop, 0, 0 };
+  }
+  return n;
+}
+
+bool DFRobotPlayerController::probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) {
+  if (serialRxPin < 0) return false;
+  const uint32_t start = millis();
+  sendCommand(type, a, b);
+  // readVolume() blocks until the module answers or setTimeOut() expires (-1).
+  if (myDFPlayer.readVolume() < 0) return false;
+  elapsedMs = (uint16_t)(millis() - start);
+  return true;
+}
+
+bool DFRobotPlayerController::probePlayStart(int testTrack, uint16_t& elapsedMs) {
+  if (serialRxPin < 0) return false;  // TX-only wiring: use setBusyPin() instead
+  const uint32_t start = millis();
+  sendCommand(DFCmd_PlayTrack, (uint16_t)testTrack, 0);
+  while ((int32_t)(millis() - start) < 2000) {
+    // readState(): DH = device, DL = 0 stopped, 1 playing, 2 paused; -1 = no answer.
+    const int state = myDFPlayer.readState();
+    if (state >= 0 && (state & 0xFF) == 1) {
+      elapsedMs = (uint16_t)(millis() - start);
+      return true;
+    }
+    delay(20);
+  }
+  return false;
+}
+
+const PlayerPeepholeRule* DFRobotPlayerController::peepholeRules(uint8_t& count) const {
+  static const PlayerPeepholeRule rules[] = {
+    { DFCmd_Stop,    DFCmd_PlayTrack },  // play() restarts playback: a stop right before it is redundant
+    { DFCmd_LoopOn,  DFCmd_LoopOff   },  // only the newest loop mode matters
+    { DFCmd_LoopOff, DFCmd_LoopOn    },
+    { DFCmd_LoopOn,  DFCmd_LoopOn    },
+    { DFCmd_LoopOff, DFCmd_LoopOff   },
+    { DFCmd_Eq,      DFCmd_Eq        },  // only the newest EQ matters
+  };
+  count = sizeof(rules) / sizeof(rules[0]);
+  return rules;
+}
+
 void DFRobotPlayerController::update() {
     PlayerController::update(); // Call the base class update method
 }
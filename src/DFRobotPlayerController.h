@@ -16,6 +16,7 @@ public:
     #else
         DFRobotPlayerController(int rxPin, int txPin);
     #endif
+    ~DFRobotPlayerController() override { stopServiceTask(); }
 
     virtual void begin() override;
     void beginFastTxOnly();
@@ -47,9 +48,39 @@ protected:
     // timings for DF (slower)
     uint16_t normalGapMs()    const override { return 120; }
     uint16_t afterPlayGapMs() const override { return 250; }
+    // play -> audio: 9600 baud frame plus SD seek; typical, calibrate for the real module
+    uint16_t playStartLatencyMs() const override { return 200; }
+    uint16_t preRollMs() const override { return 400; }  // muted lead for pre-rolled scheduled plays
     bool     isPlayCommand(uint8_t type) const override { return type == DFCmd_PlayTrack; }
+    bool     isCoalescableCommand(uint8_t type) const override { return type == DFCmd_Volume; }
+    const PlayerPeepholeRule* peepholeRules(uint8_t& count) const override;
+    PlayerCommandClass commandClass(uint8_t type) const override {
+      switch (type) {
+        case DFCmd_Stop:      return PlayerCommandClass::Urgent;
+        case DFCmd_PlayTrack: return PlayerCommandClass::Play;
+        case DFCmd_Volume:    return PlayerCommandClass::Bulk;
+        default:              return PlayerCommandClass::Control;  // LoopOn/LoopOff/Eq
+      }
+    }
     // ^^^ v2
 
+    // Shadow state. DF loop(n) starts looping file n rather than toggling a
+    // mode, so LoopOn/LoopOff are not treated as settings.
+    bool commandStateEffect(uint8_t type, uint16_t a, uint16_t b,
+                            PlayerStateKey& key, uint16_t& value) const override {
+      switch (type) {
+        case DFCmd_Volume: key = PlayerStateKey::Volume; value = a; return true;
+        case DFCmd_Eq:     key = PlayerStateKey::Eq;     value = a; return true;
+        default:           return false;
+      }
+    }
+
+    // Gap calibration: each command is followed by a readVolume() query; the
+    // query answer only arrives once the module has processed the command.
+    uint8_t calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const override;
+    bool    probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) override;
+    bool    probePlayStart(int testTrack, uint16_t& elapsedMs) override;
+
 private:
     // ---- v2
     enum : uint8_t { DFCmd_None=0, DFCmd_PlayTrack, DFCmd_Stop, DFCmd_LoopOn, DFCmd_LoopOff, DFCmd_Volume, DFCmd_Eq };
@@ -61,5 +92,4 @@ private:
     SoftwareSerial mySoftwareSerial;
 
     DFRobotDFPlayerMini myDFPlayer;
-    uint8_t lastSetPlayerVolume = 255; // Invalid value to force first update
 };
@@ -43,29 +43,33 @@ void DYPlayerController::DYPlayerController::begin() {
     DEBUG_PRINT(DebugLevel::SETUP, "%s - myDYPlayer.setPlayingDevice(%d)", __PRETTY_FUNCTION__, DY::Device::Sd);
 
     myDYPlayer.setPlayingDevice(DY::Device::Sd);
+    noteShadowState(PlayerStateKey::Device, (uint16_t)DY::Device::Sd);
     delay(slp);
 
     DEBUG_PRINT(DebugLevel::SETUP, "%s - myDYPlayer.setCycleMode(%d)", __PRETTY_FUNCTION__, DY::PlayMode::OneOff);
 
     myDYPlayer.setCycleMode(DY::PlayMode::OneOff);
+    noteShadowState(PlayerStateKey::Loop, 0);
     delay(slp);
 
     DEBUG_PRINT(DebugLevel::SETUP, "%s - myDYPlayer.setEq(%d)", __PRETTY_FUNCTION__, DY::Eq::Normal);
 
     myDYPlayer.setEq(DY::Eq::Normal);
+    noteShadowState(PlayerStateKey::Eq, 0);
     delay(slp);
 }
 
 void DYPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+  PlayerLockGuard lock(_apiMutex);
   // Create the path for the track
   char path[11];
   sprintf(path, "/%05d.mp3", track);
 
   Serial.printf("  ▶️ %s - track: %u (Dec) '%s', duration: %lu ms\n", __PRETTY_FUNCTION__, track, trackName, durationMs);
 
-  executePlayerCommandNowBase(DYCmd_PlayTrack, (uint16_t)track);
+  const uint16_t ticket = submitPlayerCommandBase(DYCmd_PlayTrack, (uint16_t)track);
   // Call the base class for status, duration and trackName
-  PlayerController::playSoundSetStatus(track, durationMs, trackName);
+  PlayerController::playSoundSetStatus(track, durationMs, trackName, ticket);
 }
 
 void DYPlayerController::playSound(int track, unsigned long durationMs, const char* trackName) {
@@ -76,8 +80,9 @@ void DYPlayerController::playSound(int track, unsigned long durationMs, const ch
 }
 
 void DYPlayerController::stop() {
+  PlayerLockGuard lock(_apiMutex);
   DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::PLAYBACK, "  ⏹️ %s - myDYPlayer.stop()", __PRETTY_FUNCTION__);
-  executePlayerCommandBase(DYCmd_Stop);
+  if (submitPlayerCommandBase(DYCmd_Stop) == 0) return;  // not queued: still playing
 //  myDYPlayer.stop();
   // Call base class for status
   PlayerController::stopSoundSetStatus();
@@ -85,20 +90,12 @@ void DYPlayerController::stop() {
 
 void DYPlayerController::setPlayerVolume(uint8_t setPlayerVolume) {
   if (setPlayerVolume > 30) setPlayerVolume = 30;
-  if (setPlayerVolume == lastSetPlayerVolume) {
-    if(debug) {
-      Serial.printf("  🔊 %s - playerVolume = %d, lastSetPlayerVolume = %d the same! Volume not set!\n",
-        __PRETTY_FUNCTION__,
-        setPlayerVolume,
-        lastSetPlayerVolume);
-    }
-    return;
-  }
-  lastSetPlayerVolume = setPlayerVolume;
   if(debug) Serial.printf("  🔊 %s - Set DY Player volume to %d\n", __PRETTY_FUNCTION__, setPlayerVolume);
-  // Use non-blocking last-wins queue instead of executePlayerCommandNowBase to avoid
+  // Use the non-blocking command queue instead of executePlayerCommandNowBase to avoid
   // blocking the main loop (and triggering soft WDT) when rapid volume commands arrive.
-  // Play commands drain the pending slot first, so volume-before-play ordering is preserved.
+  // Queued volume writes collapse to the newest value and never move past a queued
+  // play, so volume-before-play ordering is preserved. A volume the module
+  // already has is skipped by the base (shadow state).
   executePlayerCommandBase(DYCmd_Volume, setPlayerVolume);
 }
 
@@ -107,8 +104,8 @@ void DYPlayerController::setPlayerVolume(uint8_t setPlayerVolume) {
 //void DYPlayerController::disableLoop() { executePlayerCommandBase(DYCmd_SetCycle, (uint16_t)DY::PlayMode::OneOff);     isLooping = false; }
 
 // Either way works; but this option is a touch more resilient if library enums ever change value.
-void DYPlayerController::enableLoop()  { executePlayerCommandBase(DYCmd_SetCycle, 1); isLooping = true;  }
-void DYPlayerController::disableLoop() { executePlayerCommandBase(DYCmd_SetCycle, 0); isLooping = false; }
+void DYPlayerController::enableLoop()  { PlayerLockGuard lock(_apiMutex); executePlayerCommandBase(DYCmd_SetCycle, 1); isLooping = true;  }
+void DYPlayerController::disableLoop() { PlayerLockGuard lock(_apiMutex); executePlayerCommandBase(DYCmd_SetCycle, 0); isLooping = false; }
 
 //void DYPlayerController::enableLoop() {
 //
@@ -129,6 +126,7 @@ void DYPlayerController::disableLoop() { executePlayerCommandBase(DYCmd_SetCycle
 //}
 
 void DYPlayerController::setEqualizerPreset(EqualizerPreset preset) {
+  PlayerLockGuard lock(_apiMutex);
   uint8_t eq = 0; // DY::Eq::Normal
   switch (preset) {
     case EqualizerPreset::POP:     eq = 1; break; // DY::Eq::Pop
@@ -138,7 +136,7 @@ void DYPlayerController::setEqualizerPreset(EqualizerPreset preset) {
     case EqualizerPreset::BASS:    eq = 0; break; // map to Normal (DY lacks Bass)
     default:                       eq = 0; break;
   }
-  executePlayerCommandNowBase(DYCmd_Eq, eq);
+  executePlayerCommandBase(DYCmd_Eq, eq);
   PlayerController::setEqualizerPreset(preset);
 }
 
@@ -174,6 +172,16 @@ void DYPlayerController::setEqualizerPreset(EqualizerPreset preset) {
 //    PlayerController::setEqualizerPreset(preset);
 //}
 
+const PlayerPeepholeRule* DYPlayerController::peepholeRules(uint8_t& count) const {
+  // No stop->play rule: it is not verified that DY path playback implies stop.
+  static const PlayerPeepholeRule rules[] = {
+    { DYCmd_SetCycle, DYCmd_SetCycle },  // only the newest loop mode matters
+    { DYCmd_Eq,       DYCmd_Eq       },  // only the newest EQ matters
+  };
+  count = sizeof(rules) / sizeof(rules[0]);
+  return rules;
+}
+
 void DYPlayerController::update() {
     PlayerController::update(); // Call the base class update method
     // Add any DY-specific update logic here if needed
@@ -11,7 +11,6 @@ private:
   void sendCommand(uint8_t, uint16_t, uint16_t) override;
 
     DY::Player myDYPlayer;
-    int8_t lastSetPlayerVolume = -1;
     uint8_t currentVolume;
 
     SoftwareSerial mySoftwareSerial;
@@ -30,7 +29,29 @@ protected:
   // timings for DY player (pick what feels safe)
   uint16_t normalGapMs()    const override { return 80; }   // e.g. 60–100 ms
   uint16_t afterPlayGapMs() const override { return 180; }  // after PLAY a bit longer
-  bool isPlayCommand(uint8_t) const override { return false; } // (not used yet)
+  uint16_t playStartLatencyMs() const override { return 120; }  // typical play -> audio; BUSY pin calibrates
+  uint16_t preRollMs() const override { return 250; }           // muted lead for pre-rolled scheduled plays
+  bool isPlayCommand(uint8_t t) const override { return t == DYCmd_PlayTrack; }
+  bool isCoalescableCommand(uint8_t t) const override { return t == DYCmd_Volume; }
+  const PlayerPeepholeRule* peepholeRules(uint8_t& count) const override;
+  PlayerCommandClass commandClass(uint8_t t) const override {
+    switch (t) {
+      case DYCmd_Stop:      return PlayerCommandClass::Urgent;
+      case DYCmd_PlayTrack: return PlayerCommandClass::Play;
+      case DYCmd_Volume:    return PlayerCommandClass::Bulk;
+      default:              return PlayerCommandClass::Control;  // SetCycle/Eq
+    }
+  }
+
+  bool commandStateEffect(uint8_t t, uint16_t a, uint16_t b,
+                          PlayerStateKey& key, uint16_t& value) const override {
+    switch (t) {
+      case DYCmd_SetCycle: key = PlayerStateKey::Loop;   value = a ? 1 : 0;              return true;
+      case DYCmd_Volume:   key = PlayerStateKey::Volume; value = a;                      return true;
+      case DYCmd_Eq:       key = PlayerStateKey::Eq;     value = (a >= 1 && a <= 4) ? a : 0; return true;  // Bass -> Normal
+      default:             return false;
+    }
+  }
 
   const char* cmdName(uint8_t t) const override {
     switch (t) {
@@ -51,6 +72,7 @@ public:
     #else
         DYPlayerController(int rxPin, int txPin);
     #endif
+    ~DYPlayerController() override { stopServiceTask(); }
 
     void begin() override;
     void playSound(int track, unsigned long durationMs, const char* trackName);
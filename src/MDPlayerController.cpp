@@ -76,18 +76,21 @@ void MDPlayerController::selectTFCard() {
 if(debug) Serial.printf("  Selecting TF card\n");
 
     mdPlayerCommand(CMD::SEL_DEV, DEV_TF);  // select the TF card
+    noteShadowState(PlayerStateKey::Device, DEV_TF);
     delay(300);
 }
 
 void MDPlayerController::enableLoop() {
+  PlayerLockGuard lock(_apiMutex);
   if (debug) Serial.println(F("  🔁 MDPlayerController::enableLoop"));
 
   // YX5300: 0x19 00 00 00 EF = start single-cycle play
-  mdPlayerCommand(CMD::SET_SNGL_CYCL, 0);
-    isLooping = true;
+  executePlayerCommandBase(MDCmd_SetSnglCycl, 0);
+  isLooping = true;
 }
 
 void MDPlayerController::disableLoop() {
+  PlayerLockGuard lock(_apiMutex);
   if(debug) Serial.println(F("DYPlayerController: Disabling loop"));
   // YX5300: 0x19 00 00 01 EF = close single-cycle play
   executePlayerCommandBase(MDCmd_SetSnglCycl, 1);
@@ -97,14 +100,12 @@ void MDPlayerController::disableLoop() {
 
 // TODO Only print this when `DebugLevel::COMMANDS` is set
 void MDPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+    PlayerLockGuard lock(_apiMutex);
     uint16_t trackNumber = track;
     uint8_t _folder, _track;
     decodeFolderAndTrack(trackNumber, _folder, _track);
     uint16_t parameter = (_folder << 8) | _track;
 
-    // Call base class for setting status, duration and trackName
-    PlayerController::playSoundSetStatus(track, durationMs, trackName);
-
 //    DEBUG_PRINT(DebugLevel::COMMANDS | DebugLevel::PLAYBACK, "  ▶️ %s - track: %u (Dec) '%s', duration: %lu ms", __PRETTY_FUNCTION__, track, trackName, durationMs);
 //    if (debug && isLooping) {
 //      Serial.printf("  🔁 %s - loop enabled, will repeat track\n", __PRETTY_FUNCTION__);
@@ -115,8 +116,12 @@ void MDPlayerController::playTrack(int track, unsigned long durationMs, const ch
 //      mdPlayerCommand(CMD::SET_SNGL_CYCL, 0);
 //    }
 
-    executePlayerCommandNowBase(MDCmd_PlayFolderFile, parameter);
+    const uint16_t ticket = submitPlayerCommandBase(MDCmd_PlayFolderFile, parameter);
 //    mdPlayerCommand(CMD::PLAY_FOLDER_FILE, parameter);
+
+    // Call base class for setting status, duration and trackName (after the
+    // play is queued, so an ON_PLAY envelope waits for its ticket)
+    PlayerController::playSoundSetStatus(track, durationMs, trackName, ticket);
 }
 
 void MDPlayerController::playSound(int track, unsigned long durationMs, const char* trackName) {
@@ -125,9 +130,10 @@ void MDPlayerController::playSound(int track, unsigned long durationMs, const ch
 }
 
 void MDPlayerController::stop() {
+  PlayerLockGuard lock(_apiMutex);
   // TODO Only print this when `DebugLevel::COMMANDS` is set
   if(debug) Serial.printf("      %s - mdPlayerCommand(CMD::STOP_PLAY, 0)\n", __PRETTY_FUNCTION__);
-  executePlayerCommandBase(MDCmd_Stop);
+  if (submitPlayerCommandBase(MDCmd_Stop) == 0) return;  // not queued: still playing
 //  mdPlayerCommand(CMD::STOP_PLAY, 0);
   // Call base class for setting status
   PlayerController::stopSoundSetStatus();
@@ -162,21 +168,13 @@ void MDPlayerController::mdPlayerCommand(MDPlayerCommand command, uint16_t dat)
  void MDPlayerController::setPlayerVolume(uint8_t setPlayerVolume) {
   if (setPlayerVolume > 30) setPlayerVolume = 30;
 
-  if (setPlayerVolume == lastSetPlayerVolume) {
-    if(debug) {
-    Serial.printf("  🔊 %s - playerVolume = %d, lastSetPlayerVolume = %d the same! Volume not set!\n",
-      __PRETTY_FUNCTION__,
-      setPlayerVolume,
-      lastSetPlayerVolume);
-    }
-    return;
-  }
   if(debug) Serial.printf("  🔊 %s - Set MD Player volume to %d\n", __PRETTY_FUNCTION__, setPlayerVolume);
-  executePlayerCommandNowBase(MDCmd_Volume, setPlayerVolume);
+  executePlayerCommandBase(MDCmd_Volume, setPlayerVolume);
 }
 
 
 void MDPlayerController::setEqualizerPreset(EqualizerPreset preset) {
+  PlayerLockGuard lock(_apiMutex);
   uint8_t mdPreset = 0;
   switch (preset) {
     case EqualizerPreset::POP:     mdPreset = 1; break;
@@ -186,7 +184,7 @@ void MDPlayerController::setEqualizerPreset(EqualizerPreset preset) {
     case EqualizerPreset::BASS:    mdPreset = 5; break;
     default:                       mdPreset = 0; break;
   }
-  executePlayerCommandNowBase(MDCmd_Eq, mdPreset);
+  executePlayerCommandBase(MDCmd_Eq, mdPreset);
 
   // call base class for status
   PlayerController::setEqualizerPreset(preset);
@@ -227,6 +225,113 @@ void MDPlayerController::setEqualizerPreset(EqualizerPreset preset) {
 //    PlayerController::setEqualizerPreset(preset);
 //}
 
+bool MDPlayerController::waitForResponse(MDPlayerCommand command, uint16_t timeoutMs, uint16_t* data) {
+#if defined(ESP32)
+  Stream& rx = mySerial;
+#elif defined(ESP8266)
+  Stream& rx = mySoftwareSerial;
+#else
+  (void)command; (void)timeoutMs; (void)data;
+  return false;
+#endif
+#if defined(ESP32) || defined(ESP8266)
+  // Frame: 7E FF 06 CMD 00 DH DL EF — byte 3 carries the answered command.
+  uint8_t frame[8];
+  uint8_t pos = 0;
+  const uint32_t deadline = millis() + timeoutMs;
+  while ((int32_t)(millis() - deadline) < 0) {
+    if (!rx.available()) { delay(1); continue; }
+    const uint8_t b = (uint8_t)rx.read();
+    if (pos == 0 && b != 0x7e) continue;
+    frame[pos++] = b;
+    if (pos == sizeof(frame)) {
+      if (frame[7] == 0xef && frame[3] == static_cast<uint8_t>(command)) {
+        if (data) *data = (uint16_t)((frame[5] << 8) | frame[6]);
+        return true;
+      }
+      pos = 0;
+    }
+  }
+  return false;
+#endif
+}
+
+uint8_t MDPlayerController::calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const {
+#if defined(ESP32) || defined(ESP8266)
+  uint8_t n = 0;
+  uint16_t vol = MIN_VOLUME;
+  getShadowState(PlayerStateKey::Volume, vol);
+  if (n < max) out[n++] = { MDCmd_Volume, vol, 0 };
+  if (n < max) out[n++] = { MDCmd_Eq, 0, 0 };
+  if (testTrack > 0 && n + 1 < max) {
+    const uint8_t folder = (testTrack - 1) / 255 + 1;   // same as decodeFolderAndTrack()
+    const uint8_t track  = (testTrack - 1) % 255 + 1;
+    out[n++] = { MDCmd_PlayFolderFile, (uint16_t)((folder << 8) | track), 0 };
+    out[n++] = { MDCmd_Stop, 0, 0 };
+  }
+  return n;
+#else
+  return 0;
+#endif
+}
+
+bool MDPlayerController::probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) {
+#if defined(ESP32) || defined(ESP8266)
+  #if defined(ESP32)
+    while (mySerial.available()) mySerial.read();
+  #else
+    while (mySoftwareSerial.available()) mySoftwareSerial.read();
+  #endif
+  const uint32_t start = millis();
+  sendCommand(type, a, b);
+  mdPlayerCommand(CMD::QUERY_STATUS, 0);
+  if (!waitForResponse(CMD::QUERY_STATUS, 1000)) return false;
+  elapsedMs = (uint16_t)(millis() - start);
+  return true;
+#else
+  (void)type; (void)a; (void)b; (void)elapsedMs;
+  return false;
+#endif
+}
+
+// QUERY_STATUS answers DL = 0 stopped, 1 playing, 2 paused.
+bool MDPlayerController::probePlayStart(int testTrack, uint16_t& elapsedMs) {
+#if defined(ESP32) || defined(ESP8266)
+  #if defined(ESP32)
+    while (mySerial.available()) mySerial.read();
+  #else
+    while (mySoftwareSerial.available()) mySoftwareSerial.read();
+  #endif
+  const uint8_t folder = (testTrack - 1) / 255 + 1;   // same as decodeFolderAndTrack()
+  const uint8_t track  = (testTrack - 1) % 255 + 1;
+  const uint32_t start = millis();
+  sendCommand(MDCmd_PlayFolderFile, (uint16_t)((folder << 8) | track), 0);
+  while ((int32_t)(millis() - start) < 2000) {
+    mdPlayerCommand(CMD::QUERY_STATUS, 0);
+    uint16_t status = 0;
+    if (waitForResponse(CMD::QUERY_STATUS, 100, &status) && (status & 0xFF) == 1) {
+      elapsedMs = (uint16_t)(millis() - start);
+      return true;
+    }
+    delay(20);
+  }
+  return false;
+#else
+  (void)testTrack; (void)elapsedMs;
+  return false;
+#endif
+}
+
+const PlayerPeepholeRule* MDPlayerController::peepholeRules(uint8_t& count) const {
+  static const PlayerPeepholeRule rules[] = {
+    { MDCmd_Stop,        MDCmd_PlayFolderFile },  // play restarts playback: a stop right before it is redundant
+    { MDCmd_SetSnglCycl, MDCmd_SetSnglCycl    },  // only the newest loop mode matters
+    { MDCmd_Eq,          MDCmd_Eq             },  // only the newest EQ matters
+  };
+  count = sizeof(rules) / sizeof(rules[0]);
+  return rules;
+}
+
 void MDPlayerController::update() {
     PlayerController::update(); // Call the base class update method
     // Add any MD-specific update logic here if needed
@@ -234,13 +339,13 @@ void MDPlayerController::update() {
 
 void MDPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t /*b*/) {
   switch (type) {
-    case MDCmd_PlayFolderFile: mdPlayerCommand(CMD::PLAY_FOLDER_FILE, a); break; // a = (folder<<8)|file
+    case MDCmd_PlayFolderFile:
+      mdPlayerCommand(CMD::PLAY_FOLDER_FILE, a);  // a = (folder<<8)|file
+      forgetShadowState(PlayerStateKey::Loop);    // single-cycle mode ends with the old file
+      break;
     case MDCmd_Stop:           mdPlayerCommand(CMD::STOP_PLAY,        0); break;
     case MDCmd_SetSnglCycl:    mdPlayerCommand(CMD::SET_SNGL_CYCL,    a); break; // if module cares (0/1)
-    case MDCmd_Volume:
-      mdPlayerCommand(CMD::SET_VOLUME, a); // a = 0..30
-      lastSetPlayerVolume = static_cast<int8_t>(constrain(static_cast<int>(a), static_cast<int>(MIN_VOLUME), static_cast<int>(MAX_VOLUME)));
-      break;
+    case MDCmd_Volume:         mdPlayerCommand(CMD::SET_VOLUME,       a); break; // a = 0..30
     case MDCmd_Eq:             mdPlayerCommand(CMD::SET_EQUALIZER,    a); break; // a = 0..5
     default: break;
   }
@@ -20,6 +20,7 @@ public:
     #else
       MDPlayerController(int rxPin, int txPin);
     #endif
+    ~MDPlayerController() override { stopServiceTask(); }
     void begin() override;
     void playSound(int track, unsigned long durationMs, const char* trackName) override;
     void playTrack(int track, unsigned long durationMs, const char* trackName) override;
@@ -68,11 +69,12 @@ private:
     #elif defined(ESP8266)
         SoftwareSerial mySoftwareSerial;
     #endif
-    int8_t lastSetPlayerVolume = -1;  // Initialize to an invalid value
     uint8_t currentVolume; // To keep track of the current volume
     bool isLooping = false;
     void mdPlayerCommand(MDPlayerCommand command, uint16_t dat);
     void selectTFCard();
+    // Waits for a 0x7E ... 0xEF response frame carrying `command` (query answers).
+    bool waitForResponse(MDPlayerCommand command, uint16_t timeoutMs, uint16_t* data = nullptr);  // data = DH:DL
 
     // Define DEV_TF separately as it's not part of the command enum
     static constexpr uint8_t DEV_TF = 0x02;  ///< select storage device to TF card
@@ -92,7 +94,31 @@ protected:
   // per-device timing (MD is quicker than DF)
   uint16_t normalGapMs()    const override { return 80; }    // light ops
   uint16_t afterPlayGapMs() const override { return 180; }   // play needs longer
+  uint16_t playStartLatencyMs() const override { return 150; } // typical play -> audio; calibrate
+  uint16_t preRollMs() const override { return 300; }          // muted lead for pre-rolled scheduled plays
   bool isPlayCommand(uint8_t t) const override { return t == MDCmd_PlayFolderFile; }
+  bool isCoalescableCommand(uint8_t t) const override { return t == MDCmd_Volume; }
+  const PlayerPeepholeRule* peepholeRules(uint8_t& count) const override;
+  PlayerCommandClass commandClass(uint8_t t) const override {
+    switch (t) {
+      case MDCmd_Stop:           return PlayerCommandClass::Urgent;
+      case MDCmd_PlayFolderFile: return PlayerCommandClass::Play;
+      case MDCmd_Volume:         return PlayerCommandClass::Bulk;
+      default:                   return PlayerCommandClass::Control;  // SetCycl/Eq
+    }
+  }
+
+  bool commandStateEffect(uint8_t t, uint16_t a, uint16_t b,
+                          PlayerStateKey& key, uint16_t& value) const override {
+    switch (t) {
+      // Loop is 1 = on as on DY/AK (SET_SNGL_CYCL data 0 starts single-cycle
+      // play). It only applies to the file playing, so a play forgets it.
+      case MDCmd_SetSnglCycl: key = PlayerStateKey::Loop;   value = a == 0 ? 1 : 0; return true;
+      case MDCmd_Volume:      key = PlayerStateKey::Volume; value = a; return true;
+      case MDCmd_Eq:          key = PlayerStateKey::Eq;     value = a; return true;
+      default:                return false;
+    }
+  }
 
   // pretty debug name
   const char* cmdName(uint8_t t) const override {
@@ -108,6 +134,12 @@ protected:
 
   void setPlayerVolume(uint8_t playerVolume) override;
 
+  // Gap calibration: each command is followed by QUERY_STATUS; the module
+  // answers it only after it has processed the command in front of it.
+  uint8_t calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const override;
+  bool    probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) override;
+  bool    probePlayStart(int testTrack, uint16_t& elapsedMs) override;
+
 private:
 //  void sendCommand(uint8_t, uint16_t, uint16_t) override {}
   void sendCommand(uint8_t type, uint16_t a, uint16_t b) override;
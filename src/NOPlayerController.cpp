@@ -16,6 +16,7 @@ void NOPlayerController::disableLoop() {
 }
 
 void NOPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+    PlayerLockGuard lock(_apiMutex);
     PlayerController::playSoundSetStatus(track, durationMs, trackName);
 }
 
@@ -25,6 +26,7 @@ void NOPlayerController::playSound(int track, unsigned long durationMs, const ch
 }
 
 void NOPlayerController::stop() {
+  PlayerLockGuard lock(_apiMutex);
   PlayerController::stopSoundSetStatus();
 }
 
@@ -5,6 +5,7 @@ class NOPlayerController : public PlayerController {
 public:
     const char* getPlayerTypeName() const override { return "NO Player"; }
     NOPlayerController(int rxPin, int txPin);
+    ~NOPlayerController() override { stopServiceTask(); }
     void begin() override;
     void playSound(int track, unsigned long durationMs, const char* trackName) override;
     void playTrack(int track, unsigned long durationMs, const char* trackName) override;
@@ -0,0 +1,184 @@
+// PlayerClockSync.cpp
+#include "PlayerClockSync.h"
+#include "DebugLevelManager.h"
+
+// Packet (32 bytes, little endian):
+//   0..3 "BKCS"  4 version  5 type  6..7 seq  8..15 t1  16..23 t2  24..31 t3
+static const uint8_t CLOCK_SYNC_VERSION = 1;
+
+static void putU64(uint8_t* p, uint64_t v) {
+  for (uint8_t i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t getU64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (uint8_t i = 0; i < 8; ++i) v |= (uint64_t)p[i] << (8 * i);
+  return v;
+}
+
+static void putHeader(uint8_t* p, uint8_t type, uint16_t seq) {
+  p[0] = 'B'; p[1] = 'K'; p[2] = 'C'; p[3] = 'S';
+  p[4] = CLOCK_SYNC_VERSION;
+  p[5] = type;
+  p[6] = (uint8_t)seq;
+  p[7] = (uint8_t)(seq >> 8);
+}
+
+static bool isOurs(const uint8_t* p) {
+  return p[0] == 'B' && p[1] == 'K' && p[2] == 'C' && p[3] == 'S' && p[4] == CLOCK_SYNC_VERSION;
+}
+
+bool PlayerClockSync::beginMaster(uint16_t port) {
+  _master = true;
+  _started = _udp.begin(port) != 0;
+  DEBUG_PRINT(DebugLevel::NETWORK, "🕒 %s - clock master on port %u: %s", __PRETTY_FUNCTION__, port, _started ? "ok" : "FAILED");
+  return _started;
+}
+
+bool PlayerClockSync::beginClient(IPAddress master, uint16_t masterPort, uint16_t localPort) {
+  _master = false;
+  _masterIp = master;
+  _masterPort = masterPort;
+  _started = _udp.begin(localPort) != 0;
+  _lastPollMs = millis() - PLAYER_CLOCK_SYNC_POLL_MS;  // first request on the next update()
+  DEBUG_PRINT(DebugLevel::NETWORK, "🕒 %s - clock client: %s", __PRETTY_FUNCTION__, _started ? "ok" : "FAILED");
+  return _started;
+}
+
+uint64_t PlayerClockSync::localMicros() {
+  const uint32_t now = micros();
+  if (now < _lastMicros) _wraps++;
+  _lastMicros = now;
+  return (_wraps << 32) | now;
+}
+
+void PlayerClockSync::update() {
+  if (!_started) return;
+
+  // Drain everything that arrived; stamp each packet as early as possible.
+  uint8_t packet[PACKET_SIZE];
+  while (_udp.parsePacket() > 0) {
+    const uint64_t receivedUs = localMicros();
+    const int len = _udp.read(packet, sizeof(packet));
+    if (len != PACKET_SIZE || !isOurs(packet)) continue;
+    if (_master && packet[5] == MSG_REQUEST) answer_(packet, receivedUs);
+    else if (!_master && packet[5] == MSG_RESPONSE) takeSample_(packet, receivedUs);
+  }
+
+  if (!_master && (int32_t)(millis() - _lastPollMs) >= (int32_t)PLAYER_CLOCK_SYNC_POLL_MS) {
+    _lastPollMs = millis();
+    sendRequest_();
+  }
+}
+
+void PlayerClockSync::sendRequest_() {
+  uint8_t packet[PACKET_SIZE] = {};
+  putHeader(packet, MSG_REQUEST, ++_seq);
+  _udp.beginPacket(_masterIp, _masterPort);
+  putU64(packet + 8, localMicros());  // t1, stamped last
+  _udp.write(packet, sizeof(packet));
+  _udp.endPacket();
+}
+
+// Master: echo t1, add receive (t2) and transmit (t3) time.
+void PlayerClockSync::answer_(const uint8_t* request, uint64_t receivedUs) {
+  uint8_t packet[PACKET_SIZE];
+  memcpy(packet, request, sizeof(packet));
+  packet[5] = MSG_RESPONSE;
+  putU64(packet + 16, receivedUs);
+  _udp.beginPacket(_udp.remoteIP(), _udp.remotePort());
+  putU64(packet + 24, localMicros());
+  _udp.write(packet, sizeof(packet));
+  _udp.endPacket();
+}
+
+// Client: one exchange. Answers to an older request (arriving after the next
+// poll) are dropped, as are impossible ones (negative round trip).
+void PlayerClockSync::takeSample_(const uint8_t* packet, uint64_t receivedUs) {
+  const uint16_t seq = (uint16_t)(packet[6] | (packet[7] << 8));
+  if (seq != _seq) return;
+  const uint64_t t1 = getU64(packet + 8), t2 = getU64(packet + 16), t3 = getU64(packet + 24);
+  const int64_t roundTrip = (int64_t)(receivedUs - t1), serverHold = (int64_t)(t3 - t2);
+  const int64_t delay = roundTrip - serverHold;
+  if (roundTrip < 0 || serverHold < 0 || delay < 0) return;
+  const int64_t offset = (((int64_t)(t2 - t1)) + ((int64_t)(t3 - receivedUs))) / 2;
+
+  _exchanges++;
+  _lastDelayUs = delay > 0xFFFFFFFFLL ? 0xFFFFFFFFUL : (uint32_t)delay;
+  if (_roundCount == 0 || _lastDelayUs < _roundBestDelayUs) {
+    _roundBestDelayUs = _lastDelayUs;
+    _roundBestOffsetUs = offset;
+    _roundBestLocalUs = receivedUs;
+  }
+  if (++_roundCount < PLAYER_CLOCK_SYNC_ROUND) return;
+
+  _ring[_ringNext].localUs = _roundBestLocalUs;
+  _ring[_ringNext].offsetUs = _roundBestOffsetUs;
+  _ringNext = (_ringNext + 1) % PLAYER_CLOCK_SYNC_POINTS;
+  if (_points < PLAYER_CLOCK_SYNC_POINTS) _points++;
+  _roundCount = 0;
+  fit_();
+
+  DEBUG_PRINT(DebugLevel::NETWORK, "🕒 CLOCK - offset %.3f ms, drift %.1f ppm, best delay %lu us (%u rounds)",
+              _offsetUs / 1000.0, getDriftPpm(), (unsigned long)_roundBestDelayUs, (unsigned)_points);
+}
+
+// Least-squares line through the kept rounds, anchored at the newest one so
+// the numbers stay small. A single round gives the offset only.
+void PlayerClockSync::fit_() {
+  const uint8_t newest = (_ringNext + PLAYER_CLOCK_SYNC_POINTS - 1) % PLAYER_CLOCK_SYNC_POINTS;
+  _refLocalUs = _ring[newest].localUs;
+  if (_points < 2) {
+    _offsetUs = _ring[newest].offsetUs;
+    _drift = 0.0;
+    return;
+  }
+  const int64_t refOffset = _ring[newest].offsetUs;
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (uint8_t i = 0; i < _points; ++i) {
+    const double x = (double)(int64_t)(_ring[i].localUs - _refLocalUs);
+    const double y = (double)(_ring[i].offsetUs - refOffset);
+    sx += x; sy += y; sxx += x * x; sxy += x * y;
+  }
+  const double n = _points, den = n * sxx - sx * sx;
+  _drift = den > 0 ? (n * sxy - sx * sy) / den : 0.0;
+  _offsetUs = refOffset + (int64_t)((sy - _drift * sx) / n);
+}
+
+uint64_t PlayerClockSync::localToShared(uint64_t localUs) const {
+  return localUs + _offsetUs + (int64_t)(_drift * (double)(int64_t)(localUs - _refLocalUs));
+}
+
+uint64_t PlayerClockSync::sharedToLocal(uint64_t sharedUs) const {
+  const int64_t d = (int64_t)(sharedUs - _offsetUs - _refLocalUs);
+  return _refLocalUs + (int64_t)((double)d / (1.0 + _drift));
+}
+
+uint64_t PlayerClockSync::sharedMicros() {
+  return localToShared(localMicros());
+}
+
+PlayerController::ScheduleHandle PlayerClockSync::schedulePlayAt(PlayerController& player, uint32_t sharedAtMs, int track,
+                                                                 unsigned long durationMs, const char* trackName, int volume,
+                                                                 bool preRoll) {
+  if (!isSynced()) {
+    DEBUG_PRINT(DebugLevel::NETWORK, "⚠️ %s - not synced yet, track %d not scheduled", __PRETTY_FUNCTION__, track);
+    return 0;
+  }
+  // Place the 32-bit shared ms next to the 64-bit shared clock.
+  const uint64_t nowLocal = localMicros();
+  const uint64_t nowSharedMs = localToShared(nowLocal) / 1000;
+  const int32_t aheadMs = (int32_t)(sharedAtMs - (uint32_t)nowSharedMs);
+  if (aheadMs < 0) {
+    DEBUG_PRINT(DebugLevel::NETWORK, "⚠️ %s - shared %lu ms is %ld ms past, track %d not scheduled",
+                __PRETTY_FUNCTION__, (unsigned long)sharedAtMs, (long)-aheadMs, track);
+    return 0;
+  }
+  // millis() == micros() / 1000, so counting whole local ms from now lands
+  // in the ms that contains the shared instant.
+  const uint64_t atLocal = sharedToLocal((nowSharedMs + aheadMs) * 1000);
+  const uint32_t countdownMs = (uint32_t)(atLocal / 1000 - nowLocal / 1000);
+  DEBUG_PRINT(DebugLevel::NETWORK, "🕒▶️ %s - track %d at shared %lu ms, local countdown %lu ms",
+              __PRETTY_FUNCTION__, track, (unsigned long)sharedAtMs, (unsigned long)countdownMs);
+  return player.schedulePlay(track, durationMs, trackName, volume, countdownMs, preRoll);
+}
@@ -0,0 +1,133 @@
+// PlayerClockSync.h
+#pragma once
+#include <Arduino.h>
+#include <Udp.h>
+#include "BauklankPlayerController.h"
+
+#ifndef PLAYER_CLOCK_SYNC_PORT
+// UDP port the master answers on.
+#define PLAYER_CLOCK_SYNC_PORT 47000
+#endif
+
+#ifndef PLAYER_CLOCK_SYNC_POLL_MS
+// Interval between timestamp exchanges with the master (client).
+#define PLAYER_CLOCK_SYNC_POLL_MS 200
+#endif
+
+#ifndef PLAYER_CLOCK_SYNC_ROUND
+// Exchanges per round; the one with the shortest round trip is kept.
+#define PLAYER_CLOCK_SYNC_ROUND 8
+#endif
+
+#ifndef PLAYER_CLOCK_SYNC_POINTS
+// Kept rounds the offset/drift line is fitted through (~13 s at the defaults).
+#define PLAYER_CLOCK_SYNC_POINTS 8
+#endif
+
+// Shared clock for multi-node installations: NTP-style timestamp exchanges
+// over UDP against one master, so every node can start a sound at the same
+// shared instant instead of "countdown ms after the trigger arrived".
+//
+// The shared timeline is the master's micros() (extended to 64 bits). A
+// client sends its local time t1; the master stamps receive t2 and transmit
+// t3; the client stamps the answer t4. Per exchange:
+//
+//   offset = ((t2 - t1) + (t3 - t4)) / 2      delay = (t4 - t1) - (t3 - t2)
+//
+// Queueing only ever adds delay, so each round keeps the exchange with the
+// shortest round trip (NTP clock filter). A least-squares line through the
+// last PLAYER_CLOCK_SYNC_POINTS rounds gives offset and drift (crystal
+// tolerance, typically 10..100 ppm), which keeps the estimate good between
+// polls and over long countdowns.
+//
+//   WiFiUDP udp;
+//   PlayerClockSync clock(udp);
+//   clock.beginClient(IPAddress(192, 168, 4, 1));   // clock.beginMaster() on the master
+//   ...
+//   clock.update();                                 // every loop
+//   player.update();
+//   ...
+//   // cue received from the show controller: "track 12 at shared ms 815000"
+//   clock.schedulePlayAt(player, 815000, 12, 60000, "bed");
+//
+// Not thread-safe: call everything from the loop that calls update().
+class PlayerClockSync {
+public:
+  explicit PlayerClockSync(UDP& udp) : _udp(udp) {}
+
+  // The master's clock is the shared clock; it answers any number of clients.
+  bool beginMaster(uint16_t port = PLAYER_CLOCK_SYNC_PORT);
+  // localPort 0 lets the stack pick one.
+  bool beginClient(IPAddress master, uint16_t masterPort = PLAYER_CLOCK_SYNC_PORT, uint16_t localPort = 0);
+
+  // Answers requests (master) or polls and processes answers (client). Never blocks.
+  void update();
+
+  bool isMaster() const { return _master; }
+  // A client is synced once two rounds are in (offset and drift known).
+  bool isSynced() const { return _master || _points >= 2; }
+
+  // Shared time now, and conversions between the local and the shared clock.
+  uint64_t sharedMicros();
+  uint32_t sharedMillis() { return (uint32_t)(sharedMicros() / 1000); }
+  uint64_t localToShared(uint64_t localUs) const;
+  uint64_t sharedToLocal(uint64_t sharedUs) const;
+
+  // Schedules a play at shared time sharedAtMs through
+  // PlayerController::schedulePlay(). The countdown is aligned to the local
+  // millis() tick, so it fires in the local ms that contains the instant.
+  // Returns 0 when not synced, already past, or the timeline is full.
+  // preRoll: see PlayerController::schedulePlay().
+  PlayerController::ScheduleHandle schedulePlayAt(PlayerController& player, uint32_t sharedAtMs, int track,
+                                                  unsigned long durationMs, const char* trackName, int volume = -1,
+                                                  bool preRoll = false);
+
+  // Estimate, for diagnostics. Offset: shared - local at the last round.
+  int64_t  getOffsetMicros() const { return _offsetUs; }
+  float    getDriftPpm() const { return (float)(_drift * 1e6); }
+  uint32_t getLastDelayMicros() const { return _lastDelayUs; }
+  uint32_t getExchangeCount() const { return _exchanges; }
+
+protected:
+  // 64-bit local clock: micros() plus counted wraps (update() must run at
+  // least every 71 minutes).
+  uint64_t localMicros();
+
+private:
+  static const uint8_t PACKET_SIZE = 32;
+  enum : uint8_t { MSG_REQUEST = 1, MSG_RESPONSE = 2 };
+
+  void sendRequest_();
+  void answer_(const uint8_t* packet, uint64_t receivedUs);
+  void takeSample_(const uint8_t* packet, uint64_t receivedUs);
+  void fit_();
+
+  UDP&      _udp;
+  bool      _master = false;
+  bool      _started = false;
+  IPAddress _masterIp;
+  uint16_t  _masterPort = PLAYER_CLOCK_SYNC_PORT;
+
+  uint32_t  _lastMicros = 0;
+  uint64_t  _wraps = 0;
+
+  uint32_t  _lastPollMs = 0;
+  uint16_t  _seq = 0;
+  uint32_t  _exchanges = 0;
+
+  // Current round: best (shortest delay) exchange so far.
+  uint8_t   _roundCount = 0;
+  uint32_t  _roundBestDelayUs = 0;
+  int64_t   _roundBestOffsetUs = 0;
+  uint64_t  _roundBestLocalUs = 0;
+
+  // Fitted rounds (ring) and the resulting line.
+  struct Point { uint64_t localUs; int64_t offsetUs; };
+  Point     _ring[PLAYER_CLOCK_SYNC_POINTS];
+  uint8_t   _points = 0;
+  uint8_t   _ringNext = 0;
+  uint64_t  _refLocalUs = 0;   // line: offset(local) = _offsetUs + _drift * (local - _refLocalUs)
+  int64_t   _offsetUs = 0;
+  double    _drift = 0.0;
+  uint32_t  _lastDelayUs = 0;
+};
@@ -0,0 +1,89 @@
+// PlayerCommandMailbox.h
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free bounded command mailbox (Vyukov-style sequence ring).
+//
+// Producers: GPIO ISRs, network tasks, the main loop or the other ESP32 core
+// call post(). Consumer: exactly one context (PlayerController::update()) calls
+// take(). Each cell carries its own sequence number, so a consumer never sees a
+// half-written type/a/b triple: the payload is written first and published by a
+// release store of the sequence, which take() reads with acquire.
+//
+// MultiProducer = false skips the compare-and-swap on the enqueue index; use it
+// when only one context posts (or on toolchains without 32-bit atomic CAS, e.g.
+// ESP8266). N must be a power of two.
+//
+// On ESP32, ISRs that post while flash cache may be disabled need the calling
+// ISR (and therefore this inlined code) in IRAM.
+template <uint8_t N, bool MultiProducer = true>
+class PlayerCommandMailbox {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "PlayerCommandMailbox size must be a power of two");
+
+public:
+  PlayerCommandMailbox() {
+    for (uint8_t i = 0; i < N; ++i) _cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  PlayerCommandMailbox(const PlayerCommandMailbox&) = delete;
+  PlayerCommandMailbox& operator=(const PlayerCommandMailbox&) = delete;
+
+  // Returns false when the mailbox is full. Never blocks.
+  bool post(uint8_t type, uint16_t a, uint16_t b) {
+    uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &_cells[pos & (N - 1)];
+      const uint32_t seq = cell->seq.load(std::memory_order_acquire);
+      const int32_t  dif = (int32_t)(seq - pos);
+      if (dif == 0) {
+        if (!MultiProducer) {
+          _enqueuePos.store(pos + 1, std::memory_order_relaxed);
+          break;
+        }
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;  // full: the consumer has not released this cell yet
+      } else {
+        pos = _enqueuePos.load(std::memory_order_relaxed);  // another producer won
+      }
+    }
+    cell->type = type;
+    cell->a    = a;
+    cell->b    = b;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Single consumer only. Returns false when empty.
+  bool take(uint8_t& type, uint16_t& a, uint16_t& b) {
+    const uint32_t pos  = _dequeuePos.load(std::memory_order_relaxed);
+    Cell&          cell = _cells[pos & (N - 1)];
+    const uint32_t seq  = cell.seq.load(std::memory_order_acquire);
+    if ((int32_t)(seq - (pos + 1)) < 0) return false;
+    type = cell.type;
+    a    = cell.a;
+    b    = cell.b;
+    _dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    cell.seq.store(pos + N, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    const uint32_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    return (int32_t)(_cells[pos & (N - 1)].seq.load(std::memory_order_acquire) - (pos + 1)) < 0;
+  }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    uint8_t               type;
+    uint16_t              a;
+    uint16_t              b;
+  };
+
+  Cell                  _cells[N];
+  std::atomic<uint32_t> _enqueuePos { 0 };
+  std::atomic<uint32_t> _dequeuePos { 0 };
+};
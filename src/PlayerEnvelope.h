@@ -0,0 +1,86 @@
+// PlayerEnvelope.h
+#pragma once
+#include <stdint.h>
+#include "PlayerFadeCurves.h"
+
+#ifndef PLAYER_ENVELOPE_MAX_POINTS
+// Breakpoints per PlayerEnvelope (8 bytes each).
+#define PLAYER_ENVELOPE_MAX_POINTS 8
+#endif
+
+// One breakpoint: reach `volume` at `atMs` after the envelope starts, moving
+// along `curve` from the previous breakpoint.
+struct PlayerEnvelopePoint {
+  uint32_t atMs;
+  uint8_t  volume;
+  PlayerFadeCurve curve;
+};
+
+// Fixed-capacity volume envelope (automation lane), played back by
+// PlayerController::startEnvelope(). Before the first breakpoint the envelope
+// moves from whatever volume the player had when it started.
+//
+//   PlayerEnvelope duck;
+//   duck.add(   0, 20);                            // start at 20
+//   duck.add( 800,  8, PlayerFadeCurve::S_CURVE);  // dip under the voice-over
+//   duck.add(4000,  8);                            // hold
+//   duck.add(5500, 20, PlayerFadeCurve::S_CURVE);  // recover
+//   player.startEnvelope(duck, PlayerController::EnvelopeStart::ON_PLAY);
+//   player.playTrack(12, 60000, "bed");
+//
+// The controller keeps a pointer: the envelope must outlive its playback
+// (static or global), and must not be edited while it plays.
+class PlayerEnvelope {
+public:
+  static const uint8_t CAPACITY = PLAYER_ENVELOPE_MAX_POINTS;
+
+  // Appends a breakpoint. Returns false when full or when atMs is earlier than
+  // the previous breakpoint.
+  bool add(uint32_t atMs, uint8_t volume, PlayerFadeCurve curve = PlayerFadeCurve::LINEAR) {
+    if (_count >= CAPACITY || (_count > 0 && atMs < _points[_count - 1].atMs)) return false;
+    _points[_count].atMs   = atMs;
+    _points[_count].volume = volume;
+    _points[_count].curve  = curve;
+    _count++;
+    return true;
+  }
+  void clear() { _count = 0; }
+
+  // Loop: after the last breakpoint, continue from loopStartMs.
+  void setLoop(bool loop, uint32_t loopStartMs = 0) { _loop = loop; _loopStartMs = loopStartMs; }
+  bool loops() const { return _loop && _count > 0 && _loopStartMs < durationMs(); }
+
+  uint8_t  count() const { return _count; }
+  const PlayerEnvelopePoint& point(uint8_t i) const { return _points[i]; }
+  uint32_t durationMs() const { return _count ? _points[_count - 1].atMs : 0; }
+
+  // Volume at tMs after the start. startVolume is the implicit breakpoint at
+  // 0 ms. cursor is the caller's segment index (start at 0): it only moves
+  // forward between calls, so a tick costs O(1) amortised and never more than
+  // CAPACITY steps; integer math only.
+  int volumeAt(uint32_t tMs, int startVolume, uint8_t& cursor) const {
+    if (_count == 0) return startVolume;
+    if (tMs >= durationMs()) {
+      if (!loops()) return _points[_count - 1].volume;
+      tMs = _loopStartMs + (tMs - _loopStartMs) % (durationMs() - _loopStartMs);
+    }
+    if (cursor > _count || (cursor > 0 && tMs < _points[cursor - 1].atMs)) cursor = 0;  // looped
+    while (cursor < _count && _points[cursor].atMs <= tMs) cursor++;
+    if (cursor >= _count) return _points[_count - 1].volume;
+
+    const uint32_t fromMs  = cursor ? _points[cursor - 1].atMs : 0;
+    const int      fromVol = cursor ? _points[cursor - 1].volume : startVolume;
+    const PlayerEnvelopePoint& to = _points[cursor];
+    const uint32_t span = to.atMs - fromMs, t = tMs - fromMs;
+    const uint8_t step = (uint8_t)(span > 0xFFFFFFUL ? t / (span / 255) : t * 255 / span);
+    const int delta = (int)to.volume - fromVol;
+    const int applied = ((delta < 0 ? -delta : delta) * playerFadeCurveQ8(to.curve, step, 255, delta > 0) + 127) / 255;
+    return fromVol + (delta < 0 ? -applied : applied);
+  }
+
+private:
+  PlayerEnvelopePoint _points[CAPACITY] = {};
+  uint8_t  _count = 0;
+  bool     _loop = false;
+  uint32_t _loopStartMs = 0;
+};
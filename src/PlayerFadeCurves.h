@@ -0,0 +1,105 @@
+// PlayerFadeCurves.h
+#pragma once
+#include <stdint.h>
+
+// Fade curve shapes for PlayerController::fadeIn/fadeOut/fadeTo.
+//
+// Each curve maps fade progress p (0..1) to the fraction of the volume change
+// applied so far. The shapes are written for a rising fade; a falling fade
+// uses the mirrored curve 1 - s(1 - p), so EQUAL_POWER is sin() going up and
+// cos() going down, and LOGARITHMIC moves fastest near the quiet end both ways.
+//
+//   LINEAR       s = p
+//   LOGARITHMIC  s = log10(1 + 9p)       quick start, gentle finish
+//   EXPONENTIAL  s = (10^p - 1) / 9      gentle start, quick finish
+//   S_CURVE      s = p^2 (3 - 2p)        smoothstep, soft at both ends
+//   EQUAL_POWER  s = sin(p * pi / 2)     constant power for crossfades
+//
+// The tables below are computed by the compiler (C++11 constexpr, no libm), so
+// update() only does integer table lookups: no floating point at runtime,
+// which matters on FPU-less boards such as the ESP8266.
+enum class PlayerFadeCurve : uint8_t {
+  LINEAR = 0,
+  LOGARITHMIC,
+  EXPONENTIAL,
+  S_CURVE,
+  EQUAL_POWER,
+  COUNT
+};
+
+namespace player_fade_curve_detail {
+
+// Points per curve; progress i / (POINTS - 1). Values are Q8 (255 = 1.0).
+static const uint8_t POINTS = 33;
+
+constexpr double PI_ = 3.14159265358979323846;
+constexpr double LN10 = 2.30258509299404568402;
+
+// Taylor series, evaluated at compile time only.
+constexpr double expSeries(double x, int n, double term, double sum) {
+  return n > 40 ? sum : expSeries(x, n + 1, term * x / n, sum + term * x / n);
+}
+constexpr double exp_(double x) { return expSeries(x, 1, 1.0, 1.0); }
+
+// ln(y) = 2 atanh(z), z = (y - 1) / (y + 1); y in [1, 10] keeps z <= 0.82.
+constexpr double atanhSeries(double z2, double zPow, int k, double sum) {
+  return k > 201 ? sum : atanhSeries(z2, zPow * z2, k + 2, sum + zPow / k);
+}
+constexpr double ln_(double y) { return 2.0 * atanhSeries(((y - 1) / (y + 1)) * ((y - 1) / (y + 1)), (y - 1) / (y + 1), 1, 0.0); }
+
+constexpr double sinSeries(double x2, double term, int n, double sum) {
+  return n > 25 ? sum : sinSeries(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2, sum + term);
+}
+constexpr double sin_(double x) { return sinSeries(x * x, x, 1, 0.0); }
+
+constexpr double shape(PlayerFadeCurve c, double p) {
+  return c == PlayerFadeCurve::LOGARITHMIC ? ln_(1.0 + 9.0 * p) / LN10
+       : c == PlayerFadeCurve::EXPONENTIAL ? (exp_(p * LN10) - 1.0) / 9.0
+       : c == PlayerFadeCurve::S_CURVE     ? p * p * (3.0 - 2.0 * p)
+       : c == PlayerFadeCurve::EQUAL_POWER ? sin_(p * PI_ / 2.0)
+       : p;
+}
+
+constexpr uint8_t q8(double s) { return s <= 0.0 ? 0 : s >= 1.0 ? 255 : (uint8_t)(s * 255.0 + 0.5); }
+
+struct Table {
+  uint8_t v[POINTS];
+};
+
+// C++11 stand-in for std::index_sequence.
+template <int... Is> struct Indices {};
+template <int N, int... Is> struct MakeIndices : MakeIndices<N - 1, N - 1, Is...> {};
+template <int... Is> struct MakeIndices<0, Is...> { typedef Indices<Is...> type; };
+
+template <int... Is>
+constexpr Table makeTable(PlayerFadeCurve c, Indices<Is...>) {
+  return Table{ { q8(shape(c, (double)Is / (POINTS - 1)))... } };
+}
+constexpr Table makeTable(PlayerFadeCurve c) { return makeTable(c, MakeIndices<POINTS>::type()); }
+
+}  // namespace player_fade_curve_detail
+
+// Fraction (Q8, 0..255) of a fade's volume change applied at step of steps.
+// rising: the volume is going up (the curve is mirrored for falling fades).
+inline uint8_t playerFadeCurveQ8(PlayerFadeCurve curve, uint8_t step, uint8_t steps, bool rising) {
+  using namespace player_fade_curve_detail;
+  static constexpr Table TABLES[(uint8_t)PlayerFadeCurve::COUNT] = {
+    makeTable(PlayerFadeCurve::LINEAR),
+    makeTable(PlayerFadeCurve::LOGARITHMIC),
+    makeTable(PlayerFadeCurve::EXPONENTIAL),
+    makeTable(PlayerFadeCurve::S_CURVE),
+    makeTable(PlayerFadeCurve::EQUAL_POWER),
+  };
+  static_assert(TABLES[1].v[0] == 0 && TABLES[1].v[POINTS - 1] == 255, "fade curve tables must span 0..255");
+  static_assert(TABLES[4].v[POINTS / 2] == 180, "equal-power midpoint must be -3 dB");
+
+  if (steps == 0 || step >= steps) return 255;
+  const uint8_t c = (uint8_t)curve < (uint8_t)PlayerFadeCurve::COUNT ? (uint8_t)curve : 0;
+  if (!rising) step = steps - step;
+  // Position in the table in Q8, then linear interpolation between points.
+  const uint16_t pos = (uint16_t)(((uint32_t)step * (POINTS - 1) << 8) / steps);
+  const uint8_t i = pos >> 8, frac = pos & 0xFF;
+  const uint8_t* v = TABLES[c].v;
+  const uint8_t s = (i + 1 < POINTS) ? (uint8_t)(v[i] + (((int16_t)v[i + 1] - v[i]) * frac >> 8)) : v[POINTS - 1];
+  return rising ? s : 255 - s;
+}
@@ -0,0 +1,250 @@
+// PlayerPlaylist.cpp
+#include "PlayerPlaylist.h"
+#include "DebugLevelManager.h"
+
+bool PlayerPlaylist::setRange(int firstTrack, int lastTrack) {
+  _count = 0;
+  if (firstTrack <= 0 || lastTrack < firstTrack) {
+    reset();
+    return false;
+  }
+  for (int track = firstTrack; track <= lastTrack && _count < CAPACITY; ++track) {
+    _tracks[_count]  = (uint16_t)min(track, 0xFFFF);
+    _weights[_count] = 1;
+    _count++;
+  }
+  reset();
+  if (lastTrack - firstTrack + 1 > CAPACITY) {
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⚠️ %s - range %d..%d cut to %u tracks (PLAYER_PLAYLIST_MAX_TRACKS)",
+                __PRETTY_FUNCTION__, firstTrack, lastTrack, (unsigned)CAPACITY);
+    return false;
+  }
+  return true;
+}
+
+bool PlayerPlaylist::add(int track, uint8_t weight) {
+  if (_count >= CAPACITY || track <= 0) return false;
+  _tracks[_count]  = (uint16_t)min(track, 0xFFFF);
+  _weights[_count] = weight;
+  _count++;
+  reset();
+  return true;
+}
+
+void PlayerPlaylist::clear() {
+  _count = 0;
+  reset();
+}
+
+bool PlayerPlaylist::setWeight(uint8_t index, uint8_t weight) {
+  if (index >= _count) return false;
+  _weights[index] = weight;
+  _aliasValid = false;
+  return true;
+}
+
+void PlayerPlaylist::setMode(Mode mode, uint8_t avoidLast) {
+  _mode = mode;
+  _avoidLast = avoidLast;
+  reset();
+}
+
+void PlayerPlaylist::reset() {
+  _cursor = 0;
+  _poolValid = false;
+  _poolCount = 0;
+  _last = -1;
+  _recentHead = 0;
+  _recentCount = 0;
+  for (uint32_t& bits : _recentBits) bits = 0;
+  _aliasValid = false;
+}
+
+// Remembers index as the newest recent draw and drops the oldest beyond
+// `keep`; returns the dropped index, -1 if none.
+int16_t PlayerPlaylist::noteRecent_(uint8_t index, uint8_t keep) {
+  _recent[(_recentHead + _recentCount) % CAPACITY] = index;
+  _recentBits[index >> 5] |= 1UL << (index & 31);
+  _recentCount++;
+  if (_recentCount <= keep) return -1;
+  const uint8_t oldest = _recent[_recentHead];
+  _recentHead = (_recentHead + 1) % CAPACITY;
+  _recentCount--;
+  _recentBits[oldest >> 5] &= ~(1UL << (oldest & 31));
+  return oldest;
+}
+
+// Vose's alias method in integers: every column holds at most two tracks, so
+// a draw is one column pick and one comparison. O(n), only after a change.
+void PlayerPlaylist::buildAliasTables_() {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < _count; ++i) total += _weights[i];
+  if (total == 0) return;
+
+  uint32_t scaled[CAPACITY];   // weight * n, compared against total
+  uint8_t  small[CAPACITY], large[CAPACITY];
+  uint8_t  smallCount = 0, largeCount = 0;
+  for (uint8_t i = 0; i < _count; ++i) {
+    scaled[i] = (uint32_t)_weights[i] * _count;
+    if (scaled[i] < total) small[smallCount++] = i;
+    else                   large[largeCount++] = i;
+  }
+  while (smallCount && largeCount) {
+    const uint8_t s = small[--smallCount];
+    const uint8_t l = large[--largeCount];
+    _prob[s]  = (uint16_t)(scaled[s] * 32768UL / total);
+    _alias[s] = l;
+    scaled[l] -= total - scaled[s];  // l gives the rest of column s
+    if (scaled[l] < total) small[smallCount++] = l;
+    else                   large[largeCount++] = l;
+  }
+  // Whatever is left is full (up to rounding).
+  while (largeCount) { const uint8_t i = large[--largeCount]; _prob[i] = 32768; _alias[i] = i; }
+  while (smallCount) { const uint8_t i = small[--smallCount]; _prob[i] = 32768; _alias[i] = i; }
+  _aliasValid = true;
+}
+
+int16_t PlayerPlaylist::draw_() {
+  if (_count == 0) return -1;
+  const uint8_t avoid = min(_avoidLast, (uint8_t)(_count - 1));
+  int16_t pick = -1;
+
+  switch (_mode) {
+    case Mode::SEQUENTIAL:
+      if (_cursor >= _count) {
+        if (!_loop) return -1;
+        _cursor = 0;
+      }
+      pick = _cursor++;
+      break;
+
+    case Mode::SHUFFLE: {
+      if (!_poolValid) {
+        for (uint8_t i = 0; i < _count; ++i) _pool[i] = i;
+        _poolCount = _count;
+        _poolValid = true;
+      }
+      if (_poolCount == 0) {
+        if (!_loop) return -1;
+        _poolCount = _count;  // the array still holds every index
+      }
+      uint8_t j = (uint8_t)random(_poolCount);
+      // Fresh bag: do not open with the track that closed the last one.
+      if (_pool[j] == _last && _poolCount > 1) j = (uint8_t)((j + 1 + random(_poolCount - 1)) % _poolCount);
+      pick = _pool[j];
+      _pool[j] = _pool[--_poolCount];
+      _pool[_poolCount] = (uint8_t)pick;  // drawn tracks collect behind the bag
+      break;
+    }
+
+    case Mode::AVOID_RECENT: {
+      if (!_poolValid) {
+        for (uint8_t i = 0; i < _count; ++i) _pool[i] = i;
+        _poolCount = _count;
+        _poolValid = true;
+      }
+      const uint8_t j = (uint8_t)random(_poolCount);
+      pick = _pool[j];
+      _pool[j] = _pool[--_poolCount];
+      const int16_t back = noteRecent_((uint8_t)pick, avoid);
+      if (back >= 0) _pool[_poolCount++] = (uint8_t)back;
+      break;
+    }
+
+    case Mode::WEIGHTED: {
+      if (!_aliasValid) buildAliasTables_();
+      if (!_aliasValid) return -1;  // all weights 0
+      for (uint8_t tries = 0; ; ++tries) {
+        const uint8_t column = (uint8_t)random(_count);
+        pick = random(32768) < _prob[column] ? column : _alias[column];
+        if (avoid == 0 || !isRecent_((uint8_t)pick) || tries >= 3) break;
+      }
+      if (avoid > 0) noteRecent_((uint8_t)pick, avoid);
+      break;
+    }
+  }
+  _last = pick;
+  return pick;
+}
+
+int PlayerPlaylist::next() {
+  const int16_t pick = draw_();
+  return pick >= 0 ? _tracks[pick] : 0;
+}
+
+void PlayerPlaylist::resolve_(uint8_t index, unsigned long& durationMs, const char*& trackName) const {
+  durationMs = 0;
+  trackName  = "playlist";
+  if (_resolver && !_resolver(_tracks[index], durationMs, trackName, _resolverCtx)) {
+    durationMs = 0;
+    trackName  = "playlist";
+  }
+}
+
+// Draws until a track the player can end: with a duration, or on a backend
+// that reports the end of a track. At most one round over the list.
+int16_t PlayerPlaylist::drawPlayable_(unsigned long& durationMs, const char*& trackName) {
+  for (uint8_t tries = 0; tries < _count; ++tries) {
+    const int16_t pick = draw_();
+    if (pick < 0) return -1;
+    resolve_((uint8_t)pick, durationMs, trackName);
+    if (durationMs > 0 || _player.reportsEndOfTrack()) return pick;
+    DEBUG_PRINT(DebugLevel::COMMANDS, "⚠️ %s - track %d skipped: no duration, and %s does not report the end of a track",
+                __PRETTY_FUNCTION__, _tracks[pick], _player.getPlayerTypeName());
+  }
+  return -1;
+}
+
+void PlayerPlaylist::queueUpcoming_() {
+  unsigned long durationMs;
+  const char* trackName;
+  if (_upcoming < 0) {
+    _upcoming = drawPlayable_(durationMs, trackName);
+    if (_upcoming < 0) return;  // end of the pass: the current track is the last
+  } else {
+    resolve_((uint8_t)_upcoming, durationMs, trackName);  // retry, same track
+  }
+  _nextQueued = _player.queueNextTrack(_tracks[_upcoming], durationMs, trackName);
+}
+
+bool PlayerPlaylist::start() {
+  unsigned long durationMs;
+  const char* trackName;
+  _current = drawPlayable_(durationMs, trackName);
+  if (_current < 0) return false;
+  DEBUG_PRINT(DebugLevel::COMMANDS, "📃 %s - %u tracks, mode %u, first track %d", __PRETTY_FUNCTION__,
+              (unsigned)_count, (unsigned)_mode, _tracks[_current]);
+  _player.playTrack(_tracks[_current], durationMs, trackName);
+  _running = true;
+  _nextQueued = false;
+  _upcoming = -1;
+  queueUpcoming_();
+  return true;
+}
+
+void PlayerPlaylist::stop() {
+  _running = false;
+  _nextQueued = false;
+  _upcoming = -1;
+  _player.stop();  // also drops the queued next track
+}
+
+void PlayerPlaylist::update() {
+  if (!_running) return;
+  if (!_player.isSoundPlaying()) {
+    // Stopped by the sketch, or the last track of the pass ended.
+    _running = false;
+    _nextQueued = false;
+    _upcoming = -1;
+    return;
+  }
+  if (_nextQueued && !_player.hasQueuedNextTrack()) {
+    // The player moved on to the queued track: draw and queue the one after.
+    _nextQueued = false;
+    _current = _upcoming;
+    _upcoming = -1;
+    queueUpcoming_();
+  } else if (!_nextQueued && _upcoming >= 0) {
+    queueUpcoming_();  // refused last time: offer the same track again
+  }
+}
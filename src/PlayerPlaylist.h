@@ -0,0 +1,140 @@
+// PlayerPlaylist.h
+#pragma once
+#include <Arduino.h>
+#include "BauklankPlayerController.h"
+
+#ifndef PLAYER_PLAYLIST_MAX_TRACKS
+// Tracks one playlist can hold (max 255, ~9 bytes of state each).
+#define PLAYER_PLAYLIST_MAX_TRACKS 64
+#endif
+
+// Track selection for a PlayerController: sequential, shuffle bag, weighted
+// random or random avoiding the last N tracks, over a track range or an
+// explicit list. Every draw is O(1) (fixed arrays, no allocation):
+//
+//   SEQUENTIAL    in order, wrapping when looping.
+//   SHUFFLE       no track repeats until all have played (bag of remaining
+//                 tracks, swap-remove). A new bag never starts with the track
+//                 that ended the previous one.
+//   WEIGHTED      each track with probability weight / sum (alias method);
+//                 avoidLast > 0 redraws, a few times at most, when the draw is
+//                 one of the last avoidLast tracks.
+//   AVOID_RECENT  uniform over the tracks not among the last avoidLast
+//                 (pool of candidates plus a ring of recent ones).
+//
+// The playlist plays through queueNextTrack(), so the next track is always
+// drawn and queued while the current one plays, and starts without a gap.
+// Durations and names come from the resolver (the sketch's SoundLibrary).
+// Only AK notices the end of a file by itself (reportsEndOfTrack()); on DF,
+// DY, MD and XY the duration is the only way the player knows a track is
+// over, so there the playlist skips tracks the resolver gives no duration.
+//
+//   static bool resolve(int track, unsigned long& durationMs, const char*& name, void*) {
+//     const Sound* s = soundLibrary.find(track);
+//     if (!s) return false;
+//     durationMs = s->durationMs; name = s->name;
+//     return true;
+//   }
+//   PlayerPlaylist playlist(player);
+//   playlist.setRange(10, 29);
+//   playlist.setMode(PlayerPlaylist::Mode::SHUFFLE);
+//   playlist.setResolver(resolve);
+//   playlist.start();
+//   ...
+//   playlist.update();   // every loop, next to player.update()
+//
+// Not thread-safe: call everything from the loop that calls update().
+class PlayerPlaylist {
+public:
+  static const uint8_t CAPACITY = PLAYER_PLAYLIST_MAX_TRACKS;
+  static_assert(PLAYER_PLAYLIST_MAX_TRACKS > 0 && PLAYER_PLAYLIST_MAX_TRACKS <= 255,
+                "PLAYER_PLAYLIST_MAX_TRACKS must be 1..255");
+
+  enum class Mode : uint8_t { SEQUENTIAL, SHUFFLE, WEIGHTED, AVOID_RECENT };
+  // false = unknown track (duration 0: skipped unless the player reports the
+  // end of a track).
+  typedef bool (*Resolver)(int track, unsigned long& durationMs, const char*& trackName, void* ctx);
+
+  explicit PlayerPlaylist(PlayerController& player) : _player(player) {}
+
+  // Contents. setRange() replaces the list (clamped to CAPACITY tracks), add()
+  // appends; both reset the selection state. Weights default to 1; weight 0
+  // excludes a track from WEIGHTED.
+  bool setRange(int firstTrack, int lastTrack);
+  bool add(int track, uint8_t weight = 1);
+  void clear();
+  bool setWeight(uint8_t index, uint8_t weight);
+  uint8_t size() const { return _count; }
+  int trackAt(uint8_t index) const { return index < _count ? _tracks[index] : 0; }
+
+  // avoidLast: AVOID_RECENT/WEIGHTED only, clamped to size() - 1.
+  void setMode(Mode mode, uint8_t avoidLast = 0);
+  Mode mode() const { return _mode; }
+  // Looping (default): SEQUENTIAL wraps and SHUFFLE refills its bag; off, the
+  // playlist ends after one pass. Random modes never run out.
+  void setLoop(bool loop) { _loop = loop; }
+  void setResolver(Resolver resolver, void* ctx = nullptr) { _resolver = resolver; _resolverCtx = ctx; }
+
+  // Playback: start() plays the first track and queues the second; update()
+  // queues the following one each time the player moves on, and retries one
+  // the player refused. The playlist stops following the player once it stops
+  // (stop() or the end of a pass). start() returns false when no track can be
+  // played.
+  bool start();
+  void stop();
+  void update();
+  bool isRunning() const { return _running; }
+  int  currentTrack() const { return _current >= 0 ? _tracks[_current] : 0; }
+  int  peekNext() const { return _upcoming >= 0 ? _tracks[_upcoming] : 0; }
+
+  // Draws the next track without playing it (for sketches that play it
+  // themselves); 0 = the pass is over. Mixing this with start()/update()
+  // skips tracks.
+  int next();
+
+  // Starts the selection over (new bag, empty history, back to the start).
+  void reset();
+
+private:
+  int16_t draw_();
+  int16_t drawPlayable_(unsigned long& durationMs, const char*& trackName);
+  void buildAliasTables_();
+  int16_t noteRecent_(uint8_t index, uint8_t keep);
+  void queueUpcoming_();
+  bool isRecent_(uint8_t index) const { return _recentBits[index >> 5] & (1UL << (index & 31)); }
+  void resolve_(uint8_t index, unsigned long& durationMs, const char*& trackName) const;
+
+  PlayerController& _player;
+  Resolver _resolver = nullptr;
+  void*    _resolverCtx = nullptr;
+
+  uint16_t _tracks[CAPACITY];
+  uint8_t  _weights[CAPACITY];
+  uint8_t  _count = 0;
+  Mode     _mode = Mode::SEQUENTIAL;
+  uint8_t  _avoidLast = 0;
+  bool     _loop = true;
+
+  // SEQUENTIAL
+  uint8_t  _cursor = 0;
+  // SHUFFLE: _pool[0.._poolCount) is the bag. AVOID_RECENT: the candidates.
+  uint8_t  _pool[CAPACITY];
+  uint8_t  _poolCount = 0;
+  bool     _poolValid = false;
+  int16_t  _last = -1;             // last drawn index
+  // AVOID_RECENT/WEIGHTED: the last _avoidLast draws, oldest first.
+  uint8_t  _recent[CAPACITY];
+  uint8_t  _recentHead = 0;
+  uint8_t  _recentCount = 0;
+  uint32_t _recentBits[(CAPACITY + 31) / 32] = {};
+  // WEIGHTED: alias tables (Vose); _prob in 1/32768, 32768 = keep the column.
+  uint16_t _prob[CAPACITY];
+  uint8_t  _alias[CAPACITY];
+  bool     _aliasValid = false;
+
+  // Playback
+  bool     _running = false;
+  bool     _nextQueued = false;    // _upcoming accepted by queueNextTrack(); false = retry
+  int16_t  _current = -1;
+  int16_t  _upcoming = -1;
+};
@@ -0,0 +1,157 @@
+// PlayerThreading.h
+#pragma once
+#include <stdint.h>
+
+// Minimal threading abstraction for the optional PlayerController service task.
+//
+//   ESP32          FreeRTOS recursive mutex + task pinned to a core
+//   Linux host     std::recursive_mutex + std::thread (builds without ARDUINO,
+//                  or with PLAYER_HOST_BUILD for the ESP32 host variant)
+//   other boards   no-op mutex, start() returns false (use update() from loop())
+//
+// The mutex is only created by create(); an uncreated mutex locks as a no-op,
+// so sketches that never start the service task pay nothing.
+
+#if defined(ESP32) && !defined(PLAYER_HOST_BUILD)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <freertos/semphr.h>
+  #define PLAYER_THREADING_FREERTOS 1
+#elif !defined(ARDUINO)
+  #include <atomic>
+  #include <chrono>
+  #include <mutex>
+  #include <thread>
+  #define PLAYER_THREADING_STD 1
+#endif
+
+class PlayerRecursiveMutex {
+public:
+  PlayerRecursiveMutex() = default;
+  PlayerRecursiveMutex(const PlayerRecursiveMutex&) = delete;
+  PlayerRecursiveMutex& operator=(const PlayerRecursiveMutex&) = delete;
+
+#if defined(PLAYER_THREADING_FREERTOS)
+  void create() { if (!_handle) _handle = xSemaphoreCreateRecursiveMutex(); }
+  void lock()   { if (_handle) xSemaphoreTakeRecursive(_handle, portMAX_DELAY); }
+  void unlock() { if (_handle) xSemaphoreGiveRecursive(_handle); }
+private:
+  SemaphoreHandle_t _handle = nullptr;
+#elif defined(PLAYER_THREADING_STD)
+  void create() { _created = true; }
+  void lock()   { if (_created) _mutex.lock(); }
+  void unlock() { if (_created) _mutex.unlock(); }
+private:
+  std::recursive_mutex _mutex;
+  bool _created = false;
+#else
+  void create() {}
+  void lock()   {}
+  void unlock() {}
+#endif
+};
+
+class PlayerLockGuard {
+public:
+  explicit PlayerLockGuard(PlayerRecursiveMutex& mutex) : _mutex(mutex) { _mutex.lock(); }
+  ~PlayerLockGuard() { _mutex.unlock(); }
+  PlayerLockGuard(const PlayerLockGuard&) = delete;
+  PlayerLockGuard& operator=(const PlayerLockGuard&) = delete;
+private:
+  PlayerRecursiveMutex& _mutex;
+};
+
+// Calls fn(ctx) every tickMs on its own task/thread until stop().
+class PlayerServiceTask {
+public:
+  using TickFn = void (*)(void* ctx);
+
+  PlayerServiceTask() = default;
+  PlayerServiceTask(const PlayerServiceTask&) = delete;
+  PlayerServiceTask& operator=(const PlayerServiceTask&) = delete;
+  ~PlayerServiceTask() { stop(); }
+
+  // priority/core/stackBytes are FreeRTOS settings; ignored on the host.
+  bool start(TickFn fn, void* ctx, uint16_t tickMs,
+             uint8_t priority = 2, int8_t core = -1, uint32_t stackBytes = 4096) {
+    if (_running || !fn || tickMs == 0) return false;
+#if defined(PLAYER_THREADING_FREERTOS)
+    if (_task) return false;  // a self-stopped task is still winding down
+#elif defined(PLAYER_THREADING_STD)
+    if (_thread.joinable()) {
+      if (_thread.get_id() == std::this_thread::get_id()) return false;
+      _thread.join();  // reap a thread that stopped itself
+    }
+#endif
+    _fn = fn;
+    _ctx = ctx;
+    _tickMs = tickMs;
+    _running = true;
+#if defined(PLAYER_THREADING_FREERTOS)
+    const BaseType_t coreId = (core < 0) ? tskNO_AFFINITY : (BaseType_t)core;
+    if (xTaskCreatePinnedToCore(&PlayerServiceTask::entry_, "player", stackBytes, this,
+                                priority, &_task, coreId) != pdPASS) {
+      _running = false;
+      return false;
+    }
+    return true;
+#elif defined(PLAYER_THREADING_STD)
+    (void)priority; (void)core; (void)stackBytes;
+    _thread = std::thread([this]() { run_(); });
+    return true;
+#else
+    (void)priority; (void)core; (void)stackBytes;
+    _running = false;
+    return false;
+#endif
+  }
+
+  // From the task itself (e.g. a callback inside fn) this only asks it to
+  // end after the current tick; waiting for itself would never return.
+  void stop() {
+    _running = false;
+#if defined(PLAYER_THREADING_FREERTOS)
+    if (_task == xTaskGetCurrentTaskHandle()) return;
+    // The task notices _running == false within one tick and deletes itself.
+    while (_task) { vTaskDelay(1); }
+#elif defined(PLAYER_THREADING_STD)
+    if (_thread.joinable() && _thread.get_id() != std::this_thread::get_id()) _thread.join();
+#endif
+  }
+
+  bool isRunning() const { return _running; }
+
+private:
+#if defined(PLAYER_THREADING_FREERTOS)
+  static void entry_(void* self) {
+    PlayerServiceTask* task = static_cast<PlayerServiceTask*>(self);
+    TickType_t last = xTaskGetTickCount();
+    const TickType_t period = pdMS_TO_TICKS(task->_tickMs) ? pdMS_TO_TICKS(task->_tickMs) : 1;
+    while (task->_running) {
+      task->_fn(task->_ctx);
+      vTaskDelayUntil(&last, period);
+    }
+    task->_task = nullptr;
+    vTaskDelete(nullptr);
+  }
+  TaskHandle_t volatile _task = nullptr;
+  volatile bool _running = false;
+#elif defined(PLAYER_THREADING_STD)
+  void run_() {
+    auto next = std::chrono::steady_clock::now();
+    while (_running) {
+      _fn(_ctx);
+      next += std::chrono::milliseconds(_tickMs);
+      std::this_thread::sleep_until(next);
+    }
+  }
+  std::thread _thread;
+  std::atomic<bool> _running { false };
+#else
+  bool _running = false;
+#endif
+
+  TickFn   _fn = nullptr;
+  void*    _ctx = nullptr;
+  uint16_t _tickMs = 0;
+};
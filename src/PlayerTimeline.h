@@ -0,0 +1,149 @@
+// PlayerTimeline.h
+#pragma once
+#include <stdint.h>
+
+// Bounded timeline of scheduled actions: a binary min-heap on fire time over a
+// fixed pool of N slots, no dynamic allocation.
+//
+// push() and cancel() are O(log N) (a slot remembers its heap position, free
+// slots are kept on a stack). The earliest entry is always at the top, so the
+// owner only compares nextFireAtMs() with the clock on each tick. Times are
+// millis() values compared overflow-safe: pending entries must lie within
+// ~24 days of each other. Entries due at the same ms fire in push order.
+//
+// Handles are never 0 and carry a per-slot generation, so a stale handle (its
+// entry already fired or cancelled) does not match a reused slot.
+template <typename Payload, uint8_t N>
+class PlayerTimeline {
+  static_assert(N > 0 && N < 255, "PlayerTimeline capacity must be 1..254");
+
+public:
+  typedef uint16_t Handle;
+
+  PlayerTimeline() { clear(); }
+
+  PlayerTimeline(const PlayerTimeline&) = delete;
+  PlayerTimeline& operator=(const PlayerTimeline&) = delete;
+
+  // Returns 0 when the timeline is full.
+  Handle push(uint32_t fireAtMs, const Payload& payload) {
+    if (_freeCount == 0) return 0;
+    const uint8_t slot = _free[--_freeCount];
+    Slot& s = _slots[slot];
+    s.fireAtMs = fireAtMs;
+    s.seq      = _seq++;
+    s.payload  = payload;
+    if (++s.gen == 0) s.gen = 1;
+    place_(_size, slot);
+    siftUp_(_size++);
+    return handleOf_(slot);
+  }
+
+  bool cancel(Handle h) {
+    if (!contains(h)) return false;
+    removeAt_(_pos[h & 0xFF]);
+    return true;
+  }
+
+  bool contains(Handle h) const {
+    const uint8_t slot = h & 0xFF;
+    return slot < N && _pos[slot] != FREE && _slots[slot].gen == (h >> 8);
+  }
+
+  // Removes the earliest entry into out if it is due at nowMs; fireAtMs (if
+  // given) receives the time it was due, not nowMs.
+  bool popDue(uint32_t nowMs, Payload& out, uint32_t* fireAtMs = nullptr) {
+    if (_size == 0 || (int32_t)(nowMs - _slots[_heap[0]].fireAtMs) < 0) return false;
+    out = _slots[_heap[0]].payload;
+    if (fireAtMs) *fireAtMs = _slots[_heap[0]].fireAtMs;
+    removeAt_(0);
+    return true;
+  }
+
+  bool     empty() const { return _size == 0; }
+  uint8_t  size() const { return _size; }
+  uint8_t  capacity() const { return N; }
+  uint32_t nextFireAtMs() const { return _size ? _slots[_heap[0]].fireAtMs : 0; }
+
+  // Pending entries in heap order (not sorted by time), i < size().
+  const Payload& payloadAt(uint8_t i) const { return _slots[_heap[i]].payload; }
+  uint32_t fireAtMsAt(uint8_t i) const { return _slots[_heap[i]].fireAtMs; }
+  Handle   handleAt(uint8_t i) const { return handleOf_(_heap[i]); }
+
+  void clear() {
+    _size = 0;
+    _freeCount = N;
+    for (uint8_t i = 0; i < N; ++i) {
+      _free[i] = N - 1 - i;  // hand out slot 0 first
+      _pos[i]  = FREE;
+    }
+  }
+
+private:
+  static const uint8_t FREE = 0xFF;
+
+  struct Slot {
+    uint32_t fireAtMs = 0;
+    uint32_t seq = 0;
+    uint8_t  gen = 0;
+    Payload  payload {};
+  };
+
+  Handle handleOf_(uint8_t slot) const { return (Handle)((uint16_t)_slots[slot].gen << 8 | slot); }
+
+  bool before_(uint8_t a, uint8_t b) const {
+    const int32_t dt = (int32_t)(_slots[a].fireAtMs - _slots[b].fireAtMs);
+    return dt < 0 || (dt == 0 && (int32_t)(_slots[a].seq - _slots[b].seq) < 0);
+  }
+
+  void place_(uint8_t pos, uint8_t slot) {
+    _heap[pos] = slot;
+    _pos[slot] = pos;
+  }
+
+  void siftUp_(uint8_t pos) {
+    const uint8_t slot = _heap[pos];
+    while (pos > 0) {
+      const uint8_t parent = (pos - 1) / 2;
+      if (!before_(slot, _heap[parent])) break;
+      place_(pos, _heap[parent]);
+      pos = parent;
+    }
+    place_(pos, slot);
+  }
+
+  void siftDown_(uint8_t pos) {
+    const uint8_t slot = _heap[pos];
+    for (;;) {
+      const uint16_t left = 2 * pos + 1;
+      if (left >= _size) break;
+      uint8_t child = (uint8_t)left;
+      if (left + 1 < _size && before_(_heap[left + 1], _heap[left])) child++;
+      if (!before_(_heap[child], slot)) break;
+      place_(pos, _heap[child]);
+      pos = child;
+    }
+    place_(pos, slot);
+  }
+
+  // Moves the last entry into the hole and restores the heap in whichever
+  // direction it is out of order.
+  void removeAt_(uint8_t pos) {
+    const uint8_t slot = _heap[pos];
+    _pos[slot] = FREE;
+    _free[_freeCount++] = slot;
+    if (pos != --_size) {
+      place_(pos, _heap[_size]);
+      if (pos > 0 && before_(_heap[pos], _heap[(pos - 1) / 2])) siftUp_(pos);
+      else siftDown_(pos);
+    }
+  }
+
+  Slot     _slots[N];
+  uint8_t  _heap[N];       // slot indices, heap-ordered by fire time
+  uint8_t  _pos[N];        // heap position of each slot, FREE if unused
+  uint8_t  _free[N];       // stack of unused slots
+  uint8_t  _freeCount = 0;
+  uint8_t  _size = 0;
+  uint32_t _seq = 0;       // push order, breaks ties between equal fire times
+};
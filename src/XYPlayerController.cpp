@@ -30,6 +30,7 @@ void XYPlayerController::begin() {
         uint8_t driveData[1] = { 0x01 };  // 01 = SD
         Serial.println(F("[XY] Switch drive to SD (0x01)"));
         sendFrameWithAck(0x0B, driveData, 1);
+        noteShadowState(PlayerStateKey::Device, 0x01);
         delay(50);
     }
 
@@ -40,6 +41,7 @@ void XYPlayerController::begin() {
 }
 
 void XYPlayerController::playTrack(int track, unsigned long durationMs, const char* trackName) {
+    PlayerLockGuard lock(_apiMutex);
     if (track <= 0) track = 1;
     if (track > 65535) track = 65535;
 
@@ -50,10 +52,10 @@ void XYPlayerController::playTrack(int track, unsigned long durationMs, const ch
                   durationMs);
 
     // For XY: 'a' = 16-bit track number, H/L encoded in sendCommand()
-    executePlayerCommandNowBase(XyCmd_PlayTrack, static_cast<uint16_t>(track), 0);
+    const uint16_t ticket = submitPlayerCommandBase(XyCmd_PlayTrack, static_cast<uint16_t>(track), 0);
 
-    // Base handles status / timers
-    PlayerController::playSoundSetStatus(track, durationMs, trackName);
+    // Base handles status / timers (untouched if the play was not queued)
+    PlayerController::playSoundSetStatus(track, durationMs, trackName, ticket);
 }
 
 void XYPlayerController::playSound(int track, unsigned long durationMs, const char* trackName) {
@@ -62,9 +64,10 @@ void XYPlayerController::playSound(int track, unsigned long durationMs, const ch
 }
 
 void XYPlayerController::stop() {
+    PlayerLockGuard lock(_apiMutex);
     Serial.printf("  ⏹️ %s - Stopping sound\n", __PRETTY_FUNCTION__);
 
-    executePlayerCommandNowBase(XyCmd_Stop);
+    if (submitPlayerCommandBase(XyCmd_Stop) == 0) return;  // not queued: still playing
 
     // Update base state
     PlayerController::stopSoundSetStatus();
@@ -72,27 +75,23 @@ void XYPlayerController::stop() {
 
 void XYPlayerController::setPlayerVolume(uint8_t v) {
     v = constrain(v, MIN_VOLUME, MAX_VOLUME);
-    if (v == _lastSetPlayerVolume) return;
-    // Use fire-and-forget (no ACK wait) for volume to avoid blocking the fade
-    // loop — each sendFrameWithAck blocks up to 150 ms, which adds 4.5 s to a
-    // 30-step 3000 ms fade. Volume steps are best-effort; a missed step only
-    // causes a minor non-linearity, not an audible glitch.
-    uint8_t data[1] = { v };
-    sendFrame(0x13, data, 1);
-    _lastSetPlayerVolume = v;
+    executePlayerCommandBase(XyCmd_Volume, v);  // skipped by the base if unchanged
 }
 
 void XYPlayerController::enableLoop() {
+    PlayerLockGuard lock(_apiMutex);
     _loopEnabled = true;
     executePlayerCommandBase(XyCmd_LoopOn);
 }
 
 void XYPlayerController::disableLoop() {
+    PlayerLockGuard lock(_apiMutex);
     _loopEnabled = false;
     executePlayerCommandBase(XyCmd_LoopOff);
 }
 
 void XYPlayerController::setEqualizerPreset(EqualizerPreset preset) {
+    PlayerLockGuard lock(_apiMutex);
     // XY supports NORMAL..CLASSIC (0..4); if BASS, fall back to NORMAL
     uint8_t eqCode = 0;
 
@@ -108,7 +107,7 @@ void XYPlayerController::setEqualizerPreset(EqualizerPreset preset) {
             break;
     }
 
-    executePlayerCommandNowBase(XyCmd_Eq, eqCode, 0);
+    executePlayerCommandBase(XyCmd_Eq, eqCode, 0);
     PlayerController::setEqualizerPreset(preset);
 }
 
@@ -153,16 +152,24 @@ void XYPlayerController::drainRx() {
 
 bool XYPlayerController::waitForAck(uint16_t timeoutMs) {
     // The XY-V17B ACK frame starts with 0xAA 0xFF.
+    return waitForResponse(0xFF, timeoutMs);
+}
+
+bool XYPlayerController::waitForResponse(uint8_t cmd, uint16_t timeoutMs, uint8_t* firstData) {
     // We use a minimal 2-byte FSM — we don't validate the full checksum
     // because the response length varies and we just need command acceptance.
+    // firstData: also read the length byte and return the first data byte
+    // (AA <cmd> <len> <data...>).
     uint32_t deadline = millis() + timeoutMs;
-    uint8_t  state    = 0;  // 0 = waiting for 0xAA, 1 = waiting for 0xFF
+    uint8_t  state    = 0;  // 0 = waiting for 0xAA, 1 = waiting for cmd, 2 = len, 3 = data
 
     while ((int32_t)(millis() - deadline) < 0) {
         if (!_serial.available()) continue;
         uint8_t b = _serial.read();
-        if      (state == 0 && b == 0xAA) { state = 1; }
-        else if (state == 1 && b == 0xFF) { return true; }
+        if      (state == 2)              { state = 3; }
+        else if (state == 3)              { *firstData = b; return true; }
+        else if (state == 0 && b == 0xAA) { state = 1; }
+        else if (state == 1 && b == cmd)  { if (!firstData) return true; state = 2; }
         else if (b == 0xAA)               { state = 1; }  // resync
         else                               { state = 0; }
     }
@@ -178,10 +185,12 @@ bool XYPlayerController::sendFrameWithAck(uint8_t cmd, const uint8_t* data, uint
     // With a player attached the first attempt ACKs and the retry gap is never
     // reached; with no/unresponsive player it used to hit delay() and crash.
     // Keep this whole path yield-free: use a non-yielding busy wait for the gap.
+    const uint32_t start = millis();
     for (uint8_t attempt = 0; attempt < XY_ACK_MAX_RETRIES; attempt++) {
         drainRx();                       // clear stale RX bytes before send
         sendFrame(cmd, data, len);
         if (waitForAck(XY_ACK_TIMEOUT_MS)) {
+            _ackLatencyMs = (uint16_t)(millis() - start);  // including retries
             if (attempt > 0) {
                 Serial.printf("[XY] ACK ok after %d retr%s\n",
                               attempt, attempt == 1 ? "y" : "ies");
@@ -203,9 +212,53 @@ bool XYPlayerController::sendFrameWithAck(uint8_t cmd, const uint8_t* data, uint
 #endif
 }
 
+uint8_t XYPlayerController::calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const {
+    uint8_t n = 0;
+    uint16_t vol = MIN_VOLUME;
+    getShadowState(PlayerStateKey::Volume, vol);
+    if (n < max) out[n++] = { XyCmd_Volume, vol, 0 };
+    if (n < max) out[n++] = { XyCmd_Eq, 0, 0 };
+    if (n < max) out[n++] = { _loopEnabled ? XyCmd_LoopOn : XyCmd_LoopOff, 0, 0 };
+    if (testTrack > 0 && n + 1 < max) {
+        out[n++] = { XyCmd_PlayTrack, (uint16_t)testTrack, 0 };
+        out[n++] = { XyCmd_Stop, 0, 0 };
+    }
+    return n;
+}
+
+bool XYPlayerController::probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) {
+    drainRx();
+    const uint32_t start = millis();
+    sendCommand(type, a, b);
+    sendFrame(XY_QUERY_PLAY_STATUS, nullptr, 0);
+    if (!waitForResponse(XY_QUERY_PLAY_STATUS, 1000)) return false;
+    elapsedMs = (uint16_t)(millis() - start);
+    return true;
+}
+
+// Play status answer: AA 01 01 <status>, 00 = stopped, 01 = playing, 02 = paused.
+bool XYPlayerController::probePlayStart(int testTrack, uint16_t& elapsedMs) {
+    drainRx();
+    const uint32_t start = millis();
+    sendCommand(XyCmd_PlayTrack, (uint16_t)testTrack, 0);
+    while ((int32_t)(millis() - start) < 2000) {
+        drainRx();
+        sendFrame(XY_QUERY_PLAY_STATUS, nullptr, 0);
+        uint8_t status = 0;
+        if (waitForResponse(XY_QUERY_PLAY_STATUS, 100, &status) && status == 0x01) {
+            elapsedMs = (uint16_t)(millis() - start);
+            return true;
+        }
+        const uint32_t next = millis() + 20;
+        while ((int32_t)(millis() - next) < 0) { /* spin, no yield */ }
+    }
+    return false;
+}
+
 void XYPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t b) {
     // a = track/volume/eq code etc.
     uint8_t data[3] = {0};
+    _ackLatencyMs = 0xFFFF;
 
     Serial.print(F("[WIRE:XY] "));
     switch (type) {
@@ -237,8 +290,11 @@ void XYPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t b) {
             Serial.print(F("setVol("));
             Serial.print(vol);
             Serial.println(F(")"));
-            sendFrameWithAck(0x13, data, 1);
-            _lastSetPlayerVolume = vol;
+            // Fire-and-forget (no ACK wait) so volume never blocks the fade
+            // loop — each sendFrameWithAck blocks up to 150 ms, which adds 4.5 s
+            // to a 30-step 3000 ms fade. Volume steps are best-effort; a missed
+            // step only causes a minor non-linearity, not an audible glitch.
+            sendFrame(0x13, data, 1);
             break;
         }
 
@@ -275,6 +331,21 @@ void XYPlayerController::sendCommand(uint8_t type, uint16_t a, uint16_t b) {
             Serial.println(F("UNKNOWN"));
             break;
     }
+
+    if (_ackLatencyMs != 0xFFFF) noteWireToStatusLatency(type, _ackLatencyMs);
+}
+
+const PlayerPeepholeRule* XYPlayerController::peepholeRules(uint8_t& count) const {
+    static const PlayerPeepholeRule rules[] = {
+        { XyCmd_Stop,    XyCmd_PlayTrack },  // "Specified Song" restarts playback: a stop right before it is redundant
+        { XyCmd_LoopOn,  XyCmd_LoopOff   },  // only the newest loop mode matters
+        { XyCmd_LoopOff, XyCmd_LoopOn    },
+        { XyCmd_LoopOn,  XyCmd_LoopOn    },
+        { XyCmd_LoopOff, XyCmd_LoopOff   },
+        { XyCmd_Eq,      XyCmd_Eq        },  // only the newest EQ matters
+    };
+    count = sizeof(rules) / sizeof(rules[0]);
+    return rules;
 }
 
 void XYPlayerController::update() {
@@ -58,6 +58,7 @@ public:
 #else
     XYPlayerController(int rxPin, int txPin);
 #endif
+    ~XYPlayerController() override { stopServiceTask(); }
 
     void begin() override;
     void playSound(int track, unsigned long durationMs, const char* trackName) override;
@@ -88,11 +89,46 @@ protected:
 
     uint16_t normalGapMs()    const override { return XY_CMD_GAP_MS; }
     uint16_t afterPlayGapMs() const override { return XY_AFTER_PLAY_GAP_MS; }
+    uint16_t playStartLatencyMs() const override { return 80; }  // typical play -> audio; calibrate
+    uint16_t preRollMs() const override { return 300; }          // covers the file open after Specified Song
     bool     isPlayCommand(uint8_t type) const override {
         return type == XyCmd_PlayTrack;
     }
+    bool     isCoalescableCommand(uint8_t type) const override {
+        return type == XyCmd_Volume;
+    }
+    const PlayerPeepholeRule* peepholeRules(uint8_t& count) const override;
+    PlayerCommandClass commandClass(uint8_t type) const override {
+        switch (type) {
+            case XyCmd_Stop:      return PlayerCommandClass::Urgent;
+            case XyCmd_PlayTrack: return PlayerCommandClass::Play;
+            case XyCmd_Volume:    return PlayerCommandClass::Bulk;
+            default:              return PlayerCommandClass::Control;  // LoopOn/LoopOff/Eq
+        }
+    }
+
+    // Shadow state: volume, EQ and loop mode are plain settings on the XY.
+    bool commandStateEffect(uint8_t type, uint16_t a, uint16_t b,
+                            PlayerStateKey& key, uint16_t& value) const override {
+        switch (type) {
+            case XyCmd_Volume:  key = PlayerStateKey::Volume; value = constrain(a, MIN_VOLUME, MAX_VOLUME); return true;
+            case XyCmd_Eq:      key = PlayerStateKey::Eq;     value = (a > 4) ? 0 : a;                     return true;
+            case XyCmd_LoopOn:  key = PlayerStateKey::Loop;   value = 1;                                   return true;
+            case XyCmd_LoopOff: key = PlayerStateKey::Loop;   value = 0;                                   return true;
+            default:            return false;
+        }
+    }
+
+    // Gap calibration: each command is followed by "query play status" (0x01).
+    // Unlike control commands, queries are answered (0xAA 0x01 ...), and only
+    // once the module has processed the command in front of it.
+    uint8_t calibrationCommands(CalibrationCommand* out, uint8_t max, int testTrack) const override;
+    bool    probeCommandLatency(uint8_t type, uint16_t a, uint16_t b, uint16_t& elapsedMs) override;
+    bool    probePlayStart(int testTrack, uint16_t& elapsedMs) override;
 
 private:
+    static constexpr uint8_t XY_QUERY_PLAY_STATUS = 0x01;
+
     enum : uint8_t {
         XyCmd_None = 0,
         XyCmd_PlayTrack,
@@ -109,6 +145,7 @@ private:
     // ACK helpers — only active when XY_ACK_ENABLED == true
     bool sendFrameWithAck(uint8_t cmd, const uint8_t* data, uint8_t len);
     bool waitForAck(uint16_t timeoutMs);
+    bool waitForResponse(uint8_t cmd, uint16_t timeoutMs, uint8_t* firstData = nullptr);  // 0xAA <cmd> frame start
     void drainRx();
 
 #if defined(ESP32)
@@ -117,6 +154,6 @@ private:
     SoftwareSerial _serial;
 #endif
 
-    uint8_t _lastSetPlayerVolume = 255; // invalid => force first write
     bool    _loopEnabled = false;
+    uint16_t _ackLatencyMs = 0xFFFF;  // last sendFrameWithAck() round trip, 0xFFFF = none
 };